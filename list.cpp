@@ -3,32 +3,395 @@
 #include <ranges>
 #include <chrono>
 #include <cstddef>
+#include <cassert>
 #include <set>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <bit>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <numeric>
+#include <string>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #define T_Convertible     template <typename _T> \
 requires std::is_convertible_v<_T, T>
 
+enum class PerfEvent {
+    Cycles,
+    Instructions,
+    L1dMisses,
+    LlcMisses,
+    DtlbMisses,
+    BranchMisses,
+    Count
+};
+
+constexpr std::string_view perf_event_name(PerfEvent event) noexcept {
+    constexpr std::array<std::string_view, static_cast<size_t>(PerfEvent::Count)> names = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses"
+    };
+    return names[static_cast<size_t>(event)];
+}
+
+struct PerfSample {
+    std::array<uint64_t, static_cast<size_t>(PerfEvent::Count)> counters{};
+    uint64_t nanoseconds = 0;
+};
+
+// One user space counter group for the calling thread, read with a single syscall.
+// perf_event_open is refused under perf_event_paranoid > 2 without CAP_PERFMON, events the PMU lacks
+// (common in VMs) are skipped one by one, and off Linux nothing is opened: counters then stay 0
+// and available() tells them apart, nanoseconds are always filled in.
+class PerfCounters {
+    static constexpr size_t events = static_cast<size_t>(PerfEvent::Count);
+
+    std::array<int, events> fds;
+    // position of each event in the group read
+    std::array<size_t, events> slots{};
+    int leader = -1;
+    size_t group_size = 0;
+
+    std::string fallback_reason;
+
+#ifdef __linux__
+    static uint64_t _cache_miss(uint64_t cache) noexcept {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    bool _read_group(std::array<uint64_t, events + 1>& values) const noexcept {
+        ssize_t bytes = sizeof(uint64_t) * (group_size + 1);
+        return ::read(leader, values.data(), bytes) == bytes;
+    }
+#endif
+
+    void _close() noexcept {
+#ifdef __linux__
+        for (int& fd : fds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+#endif
+        leader = -1;
+        group_size = 0;
+    }
+
+public:
+    PerfCounters() {
+        fds.fill(-1);
+
+#ifdef __linux__
+        const std::array<std::pair<uint32_t, uint64_t>, events> configs = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, _cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HW_CACHE, _cache_miss(PERF_COUNT_HW_CACHE_DTLB)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        }};
+
+        int error = 0;
+
+        for (size_t i = 0; i < events; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = configs[i].first;
+            attr.config = configs[i].second;
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // a pinned group is never multiplexed, deltas stay exact or the read fails
+            attr.pinned = leader < 0;
+
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC));
+
+            if (fd < 0) {
+                if (!error) error = errno;
+                continue;
+            }
+
+            if (leader < 0) leader = fd;
+            fds[i] = fd;
+            slots[i] = group_size++;
+        }
+
+        std::array<uint64_t, events + 1> values;
+
+        if (leader < 0) {
+            fallback_reason = std::string("perf_event_open: ") + std::strerror(error);
+        } else if (!_read_group(values)) {
+            _close();
+            fallback_reason = "perf counter group could not be scheduled";
+        }
+#else
+        fallback_reason = "perf events are Linux only";
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        _close();
+    }
+
+    bool available(PerfEvent event) const noexcept {
+        return fds[static_cast<size_t>(event)] >= 0;
+    }
+
+    // empty when at least one counter is live
+    const std::string& get_fallback_reason() const noexcept {
+        return fallback_reason;
+    }
+
+    PerfSample read() const noexcept {
+        PerfSample sample;
+
+#ifdef __linux__
+        std::array<uint64_t, events + 1> values;
+
+        if (leader >= 0 && _read_group(values)) {
+            for (size_t i = 0; i < events; ++i) {
+                if (fds[i] >= 0) sample.counters[i] = values[1 + slots[i]];
+            }
+        }
+#endif
+        sample.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        return sample;
+    }
+};
+
+struct PerfTotals {
+    size_t calls = 0;
+    PerfSample sum;
+};
+
+// Per call type totals. While attached, PerfScopes on this thread report here: ProfiledList's
+// public calls, and inside them the pool blocks its PerfResource hands out and takes back.
+// Scopes nest inclusively, an insert_back that grows also counts the blocks of the new pool.
+class PerfProfile {
+    static inline thread_local PerfProfile* active = nullptr;
+
+    PerfCounters counters;
+    // op names are string literals
+    std::map<std::string_view, PerfTotals> totals;
+    PerfProfile* previous = nullptr;
+    bool attached = false;
+
+    void _write_counter(std::ostream& out, PerfEvent event, uint64_t value) const {
+        if (counters.available(event)) out << value;
+    }
+
+public:
+    PerfProfile() = default;
+    PerfProfile(const PerfProfile&) = delete;
+    PerfProfile& operator=(const PerfProfile&) = delete;
+
+    ~PerfProfile() {
+        detach();
+    }
+
+    static PerfProfile* current() noexcept {
+        return active;
+    }
+
+    void attach() noexcept {
+        if (attached) return;
+
+        previous = std::exchange(active, this);
+        attached = true;
+    }
+
+    void detach() noexcept {
+        if (!attached) return;
+
+        active = previous;
+        attached = false;
+    }
+
+    PerfSample sample() const noexcept {
+        return counters.read();
+    }
+
+    // scopes close in noexcept code, a sample that cannot be recorded is dropped
+    void add(std::string_view op, const PerfSample& begin, const PerfSample& end) noexcept {
+        try {
+            PerfTotals& total = totals[op];
+            total.calls++;
+            total.sum.nanoseconds += end.nanoseconds - begin.nanoseconds;
+
+            for (size_t i = 0; i < begin.counters.size(); ++i) {
+                total.sum.counters[i] += end.counters[i] - begin.counters[i];
+            }
+        } catch (...) {}
+    }
+
+    void reset() {
+        totals.clear();
+    }
+
+    const PerfCounters& get_counters() const noexcept {
+        return counters;
+    }
+
+    const std::map<std::string_view, PerfTotals>& get_totals() const noexcept {
+        return totals;
+    }
+
+    // one row per op with raw totals, unavailable counters are left empty
+    void export_csv(std::ostream& out) const {
+        out << "op,calls,nanoseconds";
+        for (size_t i = 0; i < static_cast<size_t>(PerfEvent::Count); ++i) {
+            out << "," << perf_event_name(static_cast<PerfEvent>(i));
+        }
+        out << "\n";
+
+        for (const auto& [op, total] : totals) {
+            out << op << "," << total.calls << "," << total.sum.nanoseconds;
+
+            for (size_t i = 0; i < total.sum.counters.size(); ++i) {
+                out << ",";
+                _write_counter(out, static_cast<PerfEvent>(i), total.sum.counters[i]);
+            }
+            out << "\n";
+        }
+    }
+
+    // per call averages
+    void print(std::ostream& out) const {
+        out << std::left << std::setw(24) << "op" << std::right << std::setw(10) << "calls" << std::setw(12) << "ns/call";
+        for (size_t i = 0; i < static_cast<size_t>(PerfEvent::Count); ++i) {
+            out << std::setw(15) << perf_event_name(static_cast<PerfEvent>(i));
+        }
+        out << "\n";
+
+        for (const auto& [op, total] : totals) {
+            double calls = static_cast<double>(total.calls);
+
+            out << std::left << std::setw(24) << op << std::right << std::setw(10) << total.calls
+                << std::setw(12) << std::fixed << std::setprecision(1) << total.sum.nanoseconds / calls;
+
+            for (size_t i = 0; i < total.sum.counters.size(); ++i) {
+                if (counters.available(static_cast<PerfEvent>(i))) out << std::setw(15) << total.sum.counters[i] / calls;
+                else out << std::setw(15) << "-";
+            }
+            out << "\n";
+        }
+        out << std::defaultfloat << std::flush;
+    }
+};
+
+// Reports [construction, destruction) to the profile attached on this thread, if any.
+// Without one it costs a thread_local load, and nothing during constant evaluation.
+class PerfScope {
+    PerfProfile* profile = nullptr;
+    std::string_view op;
+    PerfSample begin;
+
+public:
+    constexpr explicit PerfScope(std::string_view op) noexcept : op(op) {
+        if !consteval {
+            profile = PerfProfile::current();
+            if (profile) begin = profile->sample();
+        }
+    }
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    constexpr ~PerfScope() {
+        if !consteval {
+            if (profile) profile->add(op, begin, profile->sample());
+        }
+    }
+};
+
+
+// nodes declaring a payload_type keep their element in a separate array, see NodeLayout::Split
+template <typename T>
+struct node_payload {
+    using type = std::byte;
+    static constexpr bool split = false;
+};
+
+template <typename T>
+requires requires { typename T::payload_type; }
+struct node_payload<T> {
+    using type = typename T::payload_type;
+    static constexpr bool split = true;
+};
 
 template <typename T, size_t Capacity>
 class NodeAllocator {
+    using Payload = typename node_payload<T>::type;
+    static constexpr bool split_payload = node_payload<T>::split;
+
+    // std::allocator + std::construct_at keep the pool usable during constant evaluation
     T* memory_pool;
     T** empty_spots;
+    // parallel to memory_pool, slot i of one belongs to slot i of the other
+    Payload* payloads = nullptr;
 
     size_t offset = 0;
     size_t capacity;
 
     size_t empty_offset = 0;
 
-    void move(auto&& other) noexcept {
+    // upstream for the blocks, nullptr -> std::allocator (the only option during constant evaluation)
+    std::pmr::memory_resource* resource = nullptr;
+
+    template <typename U>
+    constexpr U* _acquire(size_t n) {
+        if (resource) {
+            return static_cast<U*>(resource->allocate(sizeof(U) * n, alignof(U)));
+        }
+        return std::allocator<U>{}.allocate(n);
+    }
+
+    template <typename U>
+    constexpr void _release(U* ptr, size_t n) noexcept {
+        if (resource) {
+            resource->deallocate(ptr, sizeof(U) * n, alignof(U));
+        } else {
+            std::allocator<U>{}.deallocate(ptr, n);
+        }
+    }
+
+    constexpr void move(auto&& other) noexcept {
         memory_pool  = other.memory_pool;
         empty_spots  = other.empty_spots;
+        payloads     = other.payloads;
         offset       = other.offset;
         capacity     = other.capacity;
         empty_offset = other.empty_offset;
+        resource     = other.resource;
 
         other.memory_pool  = nullptr;
         other.empty_spots  = nullptr;
+        other.payloads     = nullptr;
         other.offset       = 0;
         other.capacity     = 0;
         other.empty_offset = 0;
@@ -41,38 +404,39 @@ public:
         using other = NodeAllocator<U, Capacity>;
     };
 
-    NodeAllocator() : capacity(Capacity) {
-        memory_pool = static_cast<T*>(::operator new(sizeof(T) * capacity));
-        empty_spots = static_cast<T**>(::operator new(sizeof(T*) * capacity));
-    }
+    constexpr NodeAllocator() : NodeAllocator(Capacity) {}
+
+    constexpr NodeAllocator(size_t capacity, std::pmr::memory_resource* resource = nullptr) : capacity(capacity), resource(resource) {
+        memory_pool = _acquire<T>(capacity);
+        empty_spots = _acquire<T*>(capacity);
 
-    NodeAllocator(size_t capacity) : capacity(capacity) {
-        memory_pool = static_cast<T*>(::operator new(sizeof(T) * capacity));
-        empty_spots = static_cast<T**>(::operator new(sizeof(T*) * capacity));    
+        if constexpr (split_payload) {
+            payloads = _acquire<Payload>(capacity);
+        }
     }
 
     NodeAllocator(const NodeAllocator&) = delete;
     NodeAllocator& operator=(const NodeAllocator&) = delete; 
 
-    NodeAllocator(NodeAllocator&& other) noexcept {
+    constexpr NodeAllocator(NodeAllocator&& other) noexcept {
         move(other);
     }
 
-    NodeAllocator& operator=(NodeAllocator&& other) noexcept {
+    constexpr NodeAllocator& operator=(NodeAllocator&& other) noexcept {
         if (this != &other) {
+            clear();
             move(other);
         }
         return *this;
     }
 
-    ~NodeAllocator() noexcept {
+    constexpr ~NodeAllocator() noexcept {
         clear();
     }
 
-    T* allocate(size_t) noexcept {
+    constexpr T* allocate(size_t) noexcept {
         if (empty_offset >= 1) {
             --empty_offset;
-            empty_spots[empty_offset]->~T();
             return empty_spots[empty_offset];
         } else {
 
@@ -82,46 +446,186 @@ public:
         }
     }
 
-    void deallocate(T* ptr, size_t) noexcept {
-        empty_spots[empty_offset++] = ptr;
+    // split nodes are handed the payload slot matching their own
+    template <typename... Args>
+    constexpr T* construct(Args&&... args) {
+        T* slot = allocate(1);
+
+        if constexpr (split_payload) {
+            return std::construct_at(slot, payloads + (slot - memory_pool), std::forward<Args>(args)...);
+        } else {
+            return std::construct_at(slot, std::forward<Args>(args)...);
+        }
     }
 
-    size_t get_capacity() const noexcept {
+    // the node is destroyed now, not when its slot is reused, so what it owns is released on erase
+    constexpr void deallocate(T* ptr, size_t) noexcept {
+        std::destroy_at(ptr);
+        std::construct_at(empty_spots + empty_offset++, ptr);
+    }
+
+    constexpr size_t get_capacity() const noexcept {
         return capacity;
     }
 
-    const T* const get_pointer() const noexcept {
+    constexpr const T* const get_pointer() const noexcept {
         return memory_pool;
     }
 
-    void clear() noexcept {
+    constexpr std::pmr::memory_resource* get_resource() const noexcept {
+        return resource;
+    }
+
+    constexpr bool full() const noexcept {
+        return offset == capacity && empty_offset == 0;
+    }
+
+    constexpr bool owns(const T* ptr) const noexcept {
+        return std::less_equal<const T*>{}(memory_pool, ptr) && std::less<const T*>{}(ptr, memory_pool + capacity);
+    }
+
+    constexpr void clear() noexcept {
         if (memory_pool) {
-            for (int i = 0; i < offset; ++i) {
-                (memory_pool + i)->~T();
+            // free slots were already destroyed by deallocate, sorted they can be skipped in one pass
+            std::sort(empty_spots, empty_spots + empty_offset, std::less<T*>{});
+            T** free_slot = empty_spots;
+
+            for (size_t i = 0; i < offset; ++i) {
+                if (free_slot != empty_spots + empty_offset && *free_slot == memory_pool + i) {
+                    ++free_slot;
+                    continue;
+                }
+                std::destroy_at(memory_pool + i);
             }
             offset = 0;
             empty_offset = 0;
 
-            ::operator delete(empty_spots);
-            ::operator delete(memory_pool);
+            if constexpr (split_payload) {
+                _release(payloads, capacity);
+                payloads = nullptr;
+            }
+            _release(empty_spots, capacity);
+            _release(memory_pool, capacity);
             memory_pool = nullptr;
             empty_spots = nullptr;
         }            
     }
 };
 
-template <typename T, size_t Capacity = 24>
+// Inline: element stored next to its link.
+// Split: links in one dense array, elements in a parallel one, so walks that only follow next
+// (advance, pop_back, erase_range, size bookkeeping) never pull large elements into cache.
+enum class NodeLayout {
+    Inline,
+    Split
+};
+
+// Content: the list keeps a positional hash of its elements, sum of h(x_i) * B^i mod 2^61 - 1,
+// up to date on every mutation, so operator == rejects most unequal lists without a walk and
+// hash() is O(1). Elements are only reachable as const, writing through an iterator would desync the hash.
+// What each update costs on top of the call itself:
+//   insert_front, insert_back, pop_front, pop_back     O(1)
+//   insert / erase at position i                       O(i), [0, i) is rehashed, a multiply-add per node
+//   insert_range / erase_range of k nodes at i         O(i + k)
+//   rotate(begin() + k)                                O(k)
+//   assign, sort, radix_sort, reverse, partition       O(n), a full rehash
+// So the middle costs a second walk to the position, which the hash does not reuse from the iterator;
+// n inserts at random positions go from O(n^2) node steps to about twice that, plus the arithmetic.
+enum class Hashing {
+    None,
+    Content
+};
+
+// Hashing::Content arithmetic mod the Mersenne prime 2^61 - 1, products are split in 31 bit halves
+// since MSVC has no 128 bit integer type
+constexpr uint64_t hash_modulus = (uint64_t{1} << 61) - 1;
+
+constexpr uint64_t hash_reduce(uint64_t x) noexcept {
+    x = (x & hash_modulus) + (x >> 61);
+    return x >= hash_modulus ? x - hash_modulus : x;
+}
+
+constexpr uint64_t hash_add(uint64_t a, uint64_t b) noexcept {
+    return hash_reduce(a + b);
+}
+
+constexpr uint64_t hash_sub(uint64_t a, uint64_t b) noexcept {
+    return hash_reduce(a + hash_modulus - b);
+}
+
+// a, b < 2^61
+constexpr uint64_t hash_mul(uint64_t a, uint64_t b) noexcept {
+    constexpr uint64_t low31 = (uint64_t{1} << 31) - 1;
+    constexpr uint64_t low30 = (uint64_t{1} << 30) - 1;
+
+    uint64_t a_high = a >> 31, a_low = a & low31;
+    uint64_t b_high = b >> 31, b_low = b & low31;
+
+    uint64_t middle = a_low * b_high + a_high * b_low;
+
+    // a * b = high * 2^62 + middle * 2^31 + low, and 2^61 = 1
+    return hash_reduce((a_high * b_high << 1) + (middle >> 30) + ((middle & low30) << 31) + a_low * b_low);
+}
+
+constexpr uint64_t hash_pow(uint64_t base, uint64_t exponent) noexcept {
+    uint64_t result = 1;
+
+    for (; exponent; exponent >>= 1) {
+        if (exponent & 1) result = hash_mul(result, base);
+        base = hash_mul(base, base);
+    }
+    return result;
+}
+
+constexpr uint64_t hash_base = 0x16A09E667F3BCC9ull;
+constexpr uint64_t hash_base_inverse = hash_pow(hash_base, hash_modulus - 2);
+
+static_assert(hash_mul(hash_base, hash_base_inverse) == 1);
+
+template <typename T, size_t Capacity = 24, NodeLayout Layout = NodeLayout::Inline, Hashing Hash = Hashing::None>
 class List {
+    static constexpr bool hashed = Hash == Hashing::Content;
+
+    static_assert(!hashed || requires(const T& value) {
+        { std::hash<T>{}(value) } -> std::convertible_to<size_t>;
+    }, "Hashing::Content needs std::hash<T>");
+
     class Iterator;
-    struct Node {
+    struct InlineNode {
         T element;
-        Node* next = nullptr;
+        InlineNode* next = nullptr;
 
         template <typename _T>
         requires std::is_convertible_v<_T, T>
-        Node(_T&& element) : element(std::forward<_T>(element)) {}
+        constexpr InlineNode(_T&& element) : element(std::forward<_T>(element)) {}
+
+        constexpr T& value() noexcept {
+            return element;
+        }
+    };
+
+    // link array entry, the element lives in the allocator's payload array at the same slot
+    struct SplitNode {
+        using payload_type = T;
+
+        SplitNode* next = nullptr;
+        T* payload;
+
+        template <typename _T>
+        requires std::is_convertible_v<_T, T>
+        constexpr SplitNode(T* slot, _T&& element) : payload(std::construct_at(slot, std::forward<_T>(element))) {}
+
+        constexpr ~SplitNode() {
+            std::destroy_at(payload);
+        }
+
+        constexpr T& value() const noexcept {
+            return *payload;
+        }
     };
 
+    using Node = std::conditional_t<Layout == NodeLayout::Split, SplitNode, InlineNode>;
+
     NodeAllocator<Node, Capacity> allocator;
 
     Node* head = nullptr;
@@ -129,18 +633,125 @@ class List {
 
     size_t length = 0;
 
+    struct NoHash {};
+
+    // sum of h(x_i) * B^i over the list, B^length kept alongside so appends are O(1)
+    struct ContentHash {
+        uint64_t sum = 0;
+        uint64_t power = 1;
+
+        constexpr bool operator == (const ContentHash&) const = default;
+    };
+
+    // the same for a run of nodes, inverse = B^-count
+    struct SegmentHash {
+        uint64_t sum = 0;
+        uint64_t power = 1;
+        uint64_t inverse = 1;
+    };
+
+    [[no_unique_address]] std::conditional_t<hashed, ContentHash, NoHash> content_hash;
+
+    static constexpr uint64_t _mix(uint64_t x) noexcept {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    static constexpr uint64_t _element_hash(Node* node) noexcept {
+        return hash_reduce(_mix(static_cast<uint64_t>(std::hash<T>{}(node->value()))));
+    }
+
+    static constexpr void _hash_append(SegmentHash& segment, Node* node) noexcept {
+        segment.sum = hash_add(segment.sum, hash_mul(segment.power, _element_hash(node)));
+        segment.power = hash_mul(segment.power, hash_base);
+        segment.inverse = hash_mul(segment.inverse, hash_base_inverse);
+    }
+
+    // [first, last]
+    static constexpr SegmentHash _hash_segment(Node* first, Node* last) noexcept {
+        SegmentHash segment;
+
+        for (Node* current = first;; current = current->next) {
+            _hash_append(segment, current);
+            if (current == last) break;
+        }
+        return segment;
+    }
+
+    // [head, stop)
+    constexpr SegmentHash _hash_prefix(Node* stop) const noexcept {
+        SegmentHash prefix;
+
+        for (Node* current = head; current != stop; current = current->next) {
+            _hash_append(prefix, current);
+        }
+        return prefix;
+    }
+
+    // [first, last] is about to be linked in front of after (nullptr: at the end)
+    constexpr void _hash_link_in(Node* first, Node* last, Node* after) noexcept {
+        if constexpr (hashed) {
+            SegmentHash chain = _hash_segment(first, last);
+
+            if (!after) {
+                content_hash.sum = hash_add(content_hash.sum, hash_mul(content_hash.power, chain.sum));
+            } else {
+                // sum = prefix + B^k * chain + B^m * suffix
+                SegmentHash prefix = _hash_prefix(after);
+                uint64_t suffix = hash_sub(content_hash.sum, prefix.sum);
+
+                content_hash.sum = hash_add(hash_add(prefix.sum, hash_mul(prefix.power, chain.sum)), hash_mul(chain.power, suffix));
+            }
+            content_hash.power = hash_mul(content_hash.power, chain.power);
+        }
+    }
+
+    // [first, last] is about to be unlinked, after follows last (nullptr: last is tail)
+    constexpr void _hash_link_out(Node* first, Node* last, Node* after) noexcept {
+        if constexpr (hashed) {
+            SegmentHash chain = _hash_segment(first, last);
+            uint64_t power = hash_mul(content_hash.power, chain.inverse);
+
+            if (!after) {
+                content_hash.sum = hash_sub(content_hash.sum, hash_mul(power, chain.sum));
+            } else {
+                SegmentHash prefix = _hash_prefix(first);
+                uint64_t suffix = hash_sub(hash_sub(content_hash.sum, prefix.sum), hash_mul(prefix.power, chain.sum));
+
+                content_hash.sum = hash_add(prefix.sum, hash_mul(suffix, chain.inverse));
+            }
+            content_hash.power = power;
+        }
+    }
+
+    // for operations that walk or relink the whole list anyway
+    constexpr void _rehash() noexcept {
+        if constexpr (hashed) {
+            SegmentHash all = _hash_prefix(nullptr);
+            content_hash = ContentHash{all.sum, all.power};
+        }
+    }
+
     template <typename Iterator>
     constexpr void _insert_range(size_t n, Iterator from, Node* begin, Node* end) {
+        if (!begin) return;
+
         length += n;
 
         if (from.current == head) {
+            _hash_link_in(begin, end, head);
             Node* rest = head;
             head = begin;
             end->next = rest;
         } else if (from.prev == tail || !from.current) {
+            _hash_link_in(begin, end, nullptr);
             tail->next = begin;
             tail = end;
         } else {            
+            _hash_link_in(begin, end, from.current);
             from.prev->next = begin;
             end->next = from.current;            
         }
@@ -153,17 +764,17 @@ class List {
     constexpr void _resize(size_t new_capacity) noexcept(
         std::is_nothrow_move_assignable_v<T>)
     {
-        NodeAllocator<Node, Capacity> new_allocator(new_capacity);
+        NodeAllocator<Node, Capacity> new_allocator(new_capacity, allocator.get_resource());
 
         if (head) {
-            Node* new_list = new (new_allocator.allocate(1)) Node(std::move(head->element));
+            Node* new_list = new_allocator.construct(std::move(head->value()));
             Node* current = head->next;
 
             Node* new_head = new_list;
 
             while (current != nullptr) {
                 Node* next = current->next;
-                new_list->next = new (new_allocator.allocate(1)) Node(std::move(current->element));
+                new_list->next = new_allocator.construct(std::move(current->value()));
                 current = next;
                 new_list = new_list->next;
             }
@@ -175,6 +786,128 @@ class List {
         allocator = std::move(new_allocator);
     }
 
+    constexpr void _copy_from(const List& other) {
+        for (Node* current = other.head; current != nullptr; current = current->next) {
+            _append_node(head, tail, allocator.construct(current->value()));
+        }
+        length = other.length;
+        content_hash = other.content_hash;
+    }
+
+    static constexpr void _append_node(Node*& first, Node*& last, Node* node) noexcept {
+        node->next = nullptr;
+
+        if (last) last->next = node;
+        else first = node;
+
+        last = node;
+    }
+
+    template <typename Key>
+    static constexpr bool _radix_key = (std::is_integral_v<Key> && !std::is_same_v<Key, bool>)
+        || std::is_same_v<Key, float> || std::is_same_v<Key, double>;
+
+    // maps a key to unsigned bits with the same ordering
+    template <typename Key>
+    static constexpr auto _radix_bits(Key key) noexcept {
+        if constexpr (std::is_floating_point_v<Key>) {
+            using Bits = std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>;
+            constexpr Bits sign = Bits{1} << (sizeof(Bits) * 8 - 1);
+
+            Bits bits = std::bit_cast<Bits>(key);
+            return (bits & sign) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | sign);
+        } else {
+            using Bits = std::make_unsigned_t<Key>;
+
+            if constexpr (std::is_signed_v<Key>) {
+                return static_cast<Bits>(static_cast<Bits>(key) ^ (Bits{1} << (sizeof(Bits) * 8 - 1)));
+            } else {
+                return static_cast<Bits>(key);
+            }
+        }
+    }
+
+    // [at, end) goes to out. Nodes cannot leave their pool, so only the shorter side is moved:
+    // when out is empty and [begin, at) is shorter, out takes this list's pool whole and the kept
+    // prefix moves into a pool of its own, otherwise [at, end) moves into out, reserved once.
+    // At most min(kept, handed off) element moves and one allocation.
+    constexpr void _hand_off(Iterator at, List& out) {
+        Node* first = at.current;
+
+        if (!first) return;
+
+        // counts only as far as needed to tell which side is shorter
+        size_t kept = 0;
+        Node* current = head;
+
+        while (current != first && kept <= length / 2) {
+            current = current->next;
+            kept++;
+        }
+
+        _hash_link_out(first, tail, nullptr);
+
+        if (current == first && kept < length - kept && out.length == 0) {
+            std::pmr::memory_resource* resource = allocator.get_resource();
+            Node* kept_head = first == head ? nullptr : head;
+            Node* kept_last = at.prev;
+
+            std::swap(allocator, out.allocator);
+            out.head = first;
+            out.tail = tail;
+            out.length = length - kept;
+            out._rehash();
+
+            if (allocator.get_capacity() < kept || allocator.get_resource() != resource) {
+                allocator = NodeAllocator<Node, Capacity>(std::max(kept, Capacity), resource);
+            }
+
+            head = tail = nullptr;
+            length = kept;
+
+            for (Node* node = kept_head; node != nullptr;) {
+                Node* next = node == kept_last ? nullptr : node->next;
+                _append_node(head, tail, allocator.construct(std::move(node->value())));
+                out.allocator.deallocate(node, 1);
+                node = next;
+            }
+            return;
+        }
+
+        if (first == head) {
+            head = tail = nullptr;
+        } else {
+            tail = at.prev;
+            tail->next = nullptr;
+        }
+
+        size_t moved = 0;
+        for (Node* node = first; node != nullptr; node = node->next) {
+            moved++;
+        }
+        out._confirm_avail_mem(moved);
+
+        for (Node* node = first; node != nullptr;) {
+            Node* next = node->next;
+            Node* copy = out.allocator.construct(std::move(node->value()));
+
+            out._hash_link_in(copy, copy, nullptr);
+            _append_node(out.head, out.tail, copy);
+            out.length++;
+
+            allocator.deallocate(node, 1);
+            length--;
+            node = next;
+        }
+    }
+
+    // what callbacks get to see of an element, a hashed list must not be changed behind its back
+    using Visible = std::conditional_t<hashed, const T&, T&>;
+
+    static constexpr Visible _visible(Node* node) noexcept {
+        return node->value();
+    }
+
     constexpr Iterator _revalidate_iterator(ptrdiff_t distance) noexcept {
         if (distance == 0) {
             return begin();
@@ -193,7 +926,11 @@ class List {
 
     constexpr void _confirm_avail_mem(size_t n, Iterator& from) noexcept {
         if (n + length > allocator.get_capacity()) {
-            ptrdiff_t dist = from.current - head;
+            // list position, nodes are only laid out in list order after _resize
+            ptrdiff_t dist = 0;
+            for (Node* current = head; current != from.current; current = current->next) {
+                dist++;
+            }
             _resize(allocator.get_capacity() * 1.5 + n);
             from = _revalidate_iterator(dist);              
         } 
@@ -207,22 +944,21 @@ class List {
         while (_this && _other) {
             if constexpr (C == '>')
             {
-                if (_this->element > _other->element)
+                if (_this->value() > _other->value())
                     return *this;
-                else if (_this->element < _other->element)
+                else if (_this->value() < _other->value())
                     return other;       
             }
             else if constexpr (C == '=')
             {
-                if (_this->element != _other->element)
+                if (_this->value() != _other->value())
                     return other;
-                return *this;
             } 
             else if constexpr (C == '<')
             {
-                if (_this->element < _other->element) 
+                if (_this->value() < _other->value()) 
                     return *this;
-                else if (_this->element > _other->element)
+                else if (_this->value() > _other->value())
                     return other; 
             }
 
@@ -248,9 +984,9 @@ class List {
 
 public:
     class Iterator {
-    friend class List<T, Capacity>;
-        mutable Node* prev;
-        mutable Node* current;
+    friend class List;
+        Node* prev;
+        Node* current;
 
     public:
         using value_type = T;
@@ -259,23 +995,23 @@ public:
         using reference = T&;
         using iterator_category = std::input_iterator_tag;
 
-        explicit Iterator(Node* prev, Node* current) : prev(prev), current(current) {}
-        explicit Iterator(Node* head) : current(head), prev(nullptr) {}
+        constexpr explicit Iterator(Node* prev, Node* current) : prev(prev), current(current) {}
+        constexpr explicit Iterator(Node* head) : current(head), prev(nullptr) {}
 
-        Iterator& operator = (const Iterator& other) {
+        constexpr Iterator& operator = (const Iterator& other) {
             prev = other.prev;
             current = other.current;
 
             return *this;
         }
 
-        decltype(auto) operator ++ (this auto&& self) {
+        constexpr decltype(auto) operator ++ (this auto&& self) {
             self.prev = self.current;
             self.current = self.current->next;
             return std::forward<decltype(self)>(self);
         }
 
-        Iterator operator ++ (int) const {
+        constexpr Iterator operator ++ (int) {
             Iterator temp = *this;
             prev = current;
             current = current->next;
@@ -283,68 +1019,78 @@ public:
             return temp;
         }
 
-        Iterator operator + (int increment) const {
+        constexpr Iterator operator + (int increment) const {
+            Node* before = prev;
             Node* it = current;
 
             for (int i = 0; i < increment; ++i) {
-                prev = it;
+                before = it;
                 it = it->next;
             }
 
-            return Iterator(prev, it);
+            return Iterator(before, it);
         }
 
-        decltype(auto) operator * (this auto&& self) {
-            return std::forward<decltype(self)>(self).current->element;
+        constexpr decltype(auto) operator * (this auto&& self) {
+            if constexpr (hashed) {
+                return std::as_const(self.current->value());
+            } else {
+                return std::forward<decltype(self)>(self).current->value();
+            }
         }
 
-        bool operator != (const Iterator& end) const {
+        constexpr bool operator != (const Iterator& end) const {
             return current != end.current;
         }
 
-        bool operator != (std::nullptr_t) const {
+        constexpr bool operator != (std::nullptr_t) const {
             return current != nullptr;
         }
 
-        bool operator == (std::nullptr_t) const {
+        constexpr bool operator == (std::nullptr_t) const {
             return current == nullptr;
         }
 
-        bool operator == (const Iterator& other) const {
+        constexpr bool operator == (const Iterator& other) const {
             return current == other.current;
         }
     };
 
-    explicit List(size_t capacity = Capacity) : allocator(capacity) {}
+    constexpr explicit List(size_t capacity = Capacity) : allocator(capacity) {}
+
+    // node storage comes from resource, e.g. a per-request std::pmr::monotonic_buffer_resource
+    constexpr explicit List(std::pmr::memory_resource* resource, size_t capacity = Capacity) : allocator(capacity, resource) {}
 
     template <typename InputIterator>
-    List(InputIterator first, InputIterator last) : allocator(Capacity > std::distance(first, last) ? Capacity : Capacity + std::distance(first, last)) {
+    constexpr List(InputIterator first, InputIterator last) : allocator(Capacity > std::distance(first, last) ? Capacity : Capacity + std::distance(first, last)) {
         tail = insert_range(begin(), first, last).prev;
     }
 
     template <typename... Args>
-    explicit List(Args&&... args) : allocator(Capacity > sizeof...(args) ? Capacity : (sizeof...(args) + Capacity)) {
+    requires std::conjunction_v<std::is_convertible<Args, T>...>
+    constexpr explicit List(Args&&... args) : allocator(Capacity > sizeof...(args) ? Capacity : (sizeof...(args) + Capacity)) {
         tail = insert_range(begin(), std::forward<Args>(args)...).prev;
     }
 
-    List(const List& other) : allocator(other.allocator.get_capacity()) {
-        _insert_range(other.length, begin(), other.head, other.tail);
+    constexpr List(const List& other) : allocator(other.allocator.get_capacity(), other.allocator.get_resource()) {
+        _copy_from(other);
     }
 
-    List& operator = (const List& other) noexcept {
+    constexpr List& operator = (const List& other) noexcept {
         if (this != &other) {
             clear();
-            _confirm_avail_mem(other.length + 1);
-            _insert_range(other.length, begin(), other.head, other.tail);
+            _confirm_avail_mem(other.length);
+            _copy_from(other);
         }
 
         return *this;
     }
 
-    List(List&& other) noexcept {
+    constexpr List(List&& other) noexcept {
         head = other.head;
         tail = other.tail;
         length = other.length;
+        content_hash = std::exchange(other.content_hash, {});
         allocator = std::move(other.allocator);
 
         other.head = nullptr;   
@@ -352,11 +1098,12 @@ public:
         other.length = 0;
     }
 
-    List& operator = (List&& other) noexcept {
+    constexpr List& operator = (List&& other) noexcept {
         if (this != &other) {
             head = other.head;
             tail = other.tail;
             length = other.length;
+            content_hash = std::exchange(other.content_hash, {});
             allocator = std::move(other.allocator);
     
             other.head = nullptr;   
@@ -367,7 +1114,7 @@ public:
         return *this;
     }
 
-    ~List() noexcept {
+    constexpr ~List() noexcept {
         clear();
     }
 
@@ -377,9 +1124,10 @@ public:
     }
 
     T_Convertible constexpr Iterator insert_front(_T&& element) noexcept {
-        _confirm_avail_mem(length + 1);
+        _confirm_avail_mem(1);
 
-        Node* node = new (allocator.allocate(1)) Node(std::forward<_T>(element));
+        Node* node = allocator.construct(std::forward<_T>(element));
+        _hash_link_in(node, node, head);
         
         if (!head) {
             head = tail = node;
@@ -393,9 +1141,10 @@ public:
     }
 
     T_Convertible constexpr Iterator insert_back(_T&& element) noexcept {
-        _confirm_avail_mem(length + 1);
+        _confirm_avail_mem(1);
 
-        Node* node = new (allocator.allocate(1)) Node(std::forward<_T>(element));
+        Node* node = allocator.construct(std::forward<_T>(element));
+        _hash_link_in(node, node, nullptr);
 
         if (!head) {
             head = tail = node;
@@ -409,7 +1158,7 @@ public:
     }
 
     T_Convertible constexpr Iterator insert(Iterator at, _T&& element) noexcept {
-        _confirm_avail_mem(length + 1, at);
+        _confirm_avail_mem(1, at);
 
         if (at.current == head) _UNLIKELY {
             return insert_front(std::forward<_T>(element));
@@ -419,7 +1168,8 @@ public:
             return insert_back(std::forward<_T>(element));
         }
 
-        Node* node = new (allocator.allocate(1)) Node(std::forward<_T>(element));
+        Node* node = allocator.construct(std::forward<_T>(element));
+        _hash_link_in(node, node, at.current);
 
         at.prev->next = node;
         node->next = at.current;
@@ -435,11 +1185,11 @@ public:
     constexpr Iterator insert_range(Iterator from, Range begin, Range end) noexcept {
         _confirm_avail_mem(std::distance(begin, end), from);
 
-        Node* temp = new (allocator.allocate(1)) Node(*begin);
+        Node* temp = allocator.construct(*begin);
         Node* tempPtr = temp;
 
         for (Range it = std::next(begin); it != end; ++it) {
-            Node* node = new (allocator.allocate(1)) Node(*it);
+            Node* node = allocator.construct(*it);
             temp->next = node;
             temp = temp->next;
         }
@@ -451,8 +1201,8 @@ public:
     requires std::is_convertible_v<
         typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
     >
-    constexpr Iterator insert_range(Range begin, Range end) noexcept {
-        return insert_range(begin(), begin, end);
+    constexpr Iterator insert_range(Range first, Range last) noexcept {
+        return insert_range(begin(), first, last);
     }
 
     template <typename Iteratable>
@@ -483,11 +1233,11 @@ public:
     {
         _confirm_avail_mem(n, from);
 
-        Node* temp = new (allocator.allocate(1)) Node(gen());
+        Node* temp = allocator.construct(gen());
         Node* temp_ptr = temp;
 
         for (int i = 0; i < n - 1; ++i) {
-            Node* node = new (allocator.allocate(1)) Node(gen());
+            Node* node = allocator.construct(gen());
             temp->next = node;
             temp = temp->next;
         }
@@ -495,8 +1245,9 @@ public:
         return Iterator(temp, temp->next);
     }
 
-    Iterator pop_front() noexcept {
+    constexpr Iterator pop_front() noexcept {
         Node* temp = head;
+        _hash_link_out(head, head, head->next);
 
         if (!head->next) {
             head = tail = nullptr;
@@ -511,10 +1262,11 @@ public:
         return begin();
     }
 
-    Iterator pop_back() noexcept {
+    constexpr Iterator pop_back() noexcept {
         if (!head) return Iterator(nullptr);
 
         if (head == tail) {
+            _hash_link_out(head, head, nullptr);
             allocator.deallocate(head, 1);
 
             head = tail = nullptr;
@@ -525,6 +1277,7 @@ public:
                 current = current->next;
             }
 
+            _hash_link_out(tail, tail, nullptr);
             allocator.deallocate(tail, 1);
             
             tail = current;
@@ -534,22 +1287,36 @@ public:
         return Iterator(tail);
     }
 
-    Iterator erase(Iterator at) noexcept {
+    constexpr Iterator erase(Iterator at) noexcept {
         if (at.current == head) _UNLIKELY {
             return pop_front();
         }
 
         Node* temp = at.current;
+        _hash_link_out(temp, temp, temp->next);
 
         at.prev->next = at.current->next;
 
+        if (temp == tail) {
+            tail = at.prev;
+        }
+
         allocator.deallocate(temp, 1);
         length--;
         return Iterator(at.prev, at.prev->next);
     }
 
-    Iterator erase_range(Iterator from, Iterator to) noexcept {
+    constexpr Iterator erase_range(Iterator from, Iterator to) noexcept {
         Node* current = from.current;
+        Node* before = from.current == head ? nullptr : from.prev;
+
+        if constexpr (hashed) {
+            if (current != to.current) {
+                Node* last = current;
+                while (last->next != to.current) last = last->next;
+                _hash_link_out(current, last, to.current);
+            }
+        }
 
         while (current != to.current) {
             Node* next = current->next;
@@ -558,16 +1325,20 @@ public:
             length--;
         }
 
-        if (from.current == head) {
+        if (!before) {
             head = current;
         } else {
-            from.prev->next = current;
+            before->next = current;
+        }
+
+        if (!current) {
+            tail = before;
         }
 
-        return Iterator(current);
+        return Iterator(before, current);
     }
 
-    Iterator erase_range(Iterator from) noexcept {
+    constexpr Iterator erase_range(Iterator from) noexcept {
         return erase_range(from, end());
     }
 
@@ -575,19 +1346,20 @@ public:
         clear();
         _confirm_avail_mem(n + 1);
 
-        Node* node = new (allocator.allocate(1)) Node(std::forward<_T>(val));
+        Node* node = allocator.construct(std::forward<_T>(val));
 
         head = tail = node;
 
         Node* current = head;
 
         for (int i = 0; i < n - 1; ++i) {
-            current->next = new (allocator.allocate(1)) Node(std::forward<_T>(val));
+            current->next = allocator.construct(std::forward<_T>(val));
             current = current->next;
         }
 
         tail = current;
         length = n;
+        _rehash();
     }
 
     template <typename Range>
@@ -613,28 +1385,31 @@ public:
         clear();
         _confirm_avail_mem(n + 1);
 
-        Node* node = new (allocator.allocate(1)) Node(gen());
+        Node* node = allocator.construct(gen());
 
         head = tail = node;
 
         Node* current = head;
 
         for (int i = 0; i < n - 1; ++i) {
-            current->next = new (allocator.allocate(1)) Node(gen());
+            current->next = allocator.construct(gen());
             current = current->next;
         }
 
         tail = current;
         length = n;
+        _rehash();
     }
 
-    void clear() noexcept {
+    constexpr void clear() noexcept {
         while (head != nullptr) {
             Node* temp = head;
             head = head->next;
             allocator.deallocate(temp, 1);
         }
+        tail = nullptr;
         length = 0;
+        content_hash = {};
     }
 
     constexpr void swap(const List& other) noexcept
@@ -642,16 +1417,17 @@ public:
         std::swap(head, other.head);
         std::swap(tail, other.tail);
         std::swap(length, other.length);
+        std::swap(content_hash, other.content_hash);
         std::swap(allocator, other.allocator);
     }
 
-    void unique() noexcept 
+    constexpr void unique() noexcept 
     requires requires(T left, T right) {
         { left == right } -> std::convertible_to<bool>;
     }
     {
         for (auto it = begin() + 1; it != end() && it != nullptr;) {
-            if (it.prev->element == it.current->element) {
+            if (it.prev->value() == it.current->value()) {
                 it = erase(it);
             } else {
                 ++it;
@@ -678,7 +1454,7 @@ public:
 
     _NODISCARD constexpr Iterator find(const T& to_find, Iterator from, Iterator to) const noexcept {
         for (auto it = from; it != to && it != nullptr; ++it) {
-            if (it.current->element == to_find) {
+            if (it.current->value() == to_find) {
                 return Iterator(it.current);
             }
         }
@@ -761,21 +1537,12 @@ public:
     _NODISCARD constexpr List filter(Predicate&& predicate) noexcept(
         std::is_nothrow_invocable_r_v<bool, Predicate, T>) 
     {
-        List temp(allocator.get_capacity());
-
-        Iterator it = find_if(std::forward<Predicate>(predicate));
-
-        if (it != end()) {
-            Node* node = new (temp.allocator.allocate(1)) Node(it.current->element);
-            Node* begin = node;
+        List temp(allocator.get_resource(), allocator.get_capacity());
 
-            for (; it != nullptr; ++it) {
-                if (predicate(*it)) {
-                    node->next = new (temp.allocator.allocate(1)) Node(*it);
-                    node = node->next;
-                }
+        for (Node* current = head; current != nullptr; current = current->next) {
+            if (predicate(_visible(current))) {
+                temp.insert_back(current->value());
             }
-            temp._insert_range(node - begin, temp.begin(), begin, node);
         }
         return temp;
     }
@@ -784,25 +1551,193 @@ public:
         return {from, to};
     }
 
+    // copies the first N elements out, so a List built in a constant expression can be kept as static data
+    template <size_t N>
+    _NODISCARD constexpr std::array<T, N> to_array() const noexcept {
+        std::array<T, N> result{};
+        Node* current = head;
+
+        for (size_t i = 0; i < N && current != nullptr; ++i) {
+            result[i] = current->value();
+            current = current->next;
+        }
+        return result;
+    }
+
     constexpr void merge(List& other) noexcept(
         std::is_nothrow_move_assignable_v<T>)
     {
-        _confirm_avail_mem(other.length + length + 1);
+        if (&other == this) return;
+
+        _confirm_avail_mem(other.length);
+
+        for (Node* current = other.head; current != nullptr; current = current->next) {
+            insert_back(std::move(current->value()));
+        }
+        other.clear();
+    }
+
+    constexpr void reverse() noexcept {
+        Node* prev = nullptr;
+        Node* current = head;
+
+        tail = head;
+
+        while (current != nullptr) {
+            Node* next = current->next;
+            current->next = prev;
+            prev = current;
+            current = next;
+        }
+        head = prev;
+        _rehash();
+    }
+
+    // middle becomes the first element, like std::rotate
+    constexpr void rotate(Iterator middle) noexcept {
+        if (middle.current == head || middle.current == nullptr) return;
+
+        if constexpr (hashed) {
+            // [0, k) moves behind [k, n): sum = (sum - prefix) * B^-k + prefix * B^(n - k)
+            SegmentHash prefix = _hash_prefix(middle.current);
+            uint64_t rest = hash_mul(hash_sub(content_hash.sum, prefix.sum), prefix.inverse);
+
+            content_hash.sum = hash_add(rest, hash_mul(prefix.sum, hash_mul(content_hash.power, prefix.inverse)));
+        }
+
+        tail->next = head;
+        head = middle.current;
+        tail = middle.prev;
+        tail->next = nullptr;
+    }
+
+    // elements satisfying predicate first, relative order kept in both groups;
+    // returns the first element of the second group
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    constexpr Iterator stable_partition(Predicate&& predicate) noexcept(
+        std::is_nothrow_invocable_r_v<bool, Predicate, T>)
+    {
+        Node* true_head = nullptr;
+        Node* true_tail = nullptr;
+        Node* false_head = nullptr;
+        Node* false_tail = nullptr;
 
-        Node* other_head = other.begin().current;
+        for (Node* current = head; current != nullptr;) {
+            Node* next = current->next;
 
-        Node* tail_ptr = tail;
+            if (predicate(_visible(current))) {
+                _append_node(true_head, true_tail, current);
+            } else {
+                _append_node(false_head, false_tail, current);
+            }
+            current = next;
+        }
 
-        while (other_head != nullptr) {
-            tail_ptr->next = new (allocator.allocate(1)) Node(std::move(other_head->element));
-            tail_ptr = tail_ptr->next;
-            Node* temp = other_head;
-            other_head = other_head->next;
+        if (true_tail) {
+            true_tail->next = false_head;
+            head = true_head;
+            tail = false_tail ? false_tail : true_tail;
+        } else {
+            head = false_head;
+            tail = false_tail;
         }
-        other.allocator.clear();
-        other.head = nullptr;
-        other.tail = nullptr;
-        other.length = 0;
+        _rehash();
+        return Iterator(true_tail, false_head);
+    }
+
+    // relinking keeps order for free, so this is the stable one
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    constexpr Iterator partition(Predicate&& predicate) noexcept(
+        std::is_nothrow_invocable_r_v<bool, Predicate, T>)
+    {
+        return stable_partition(std::forward<Predicate>(predicate));
+    }
+
+    // keeps [begin, at), returns [at, end).
+    // Not a relink: a node cannot leave its pool, so the shorter side is move constructed into another
+    // pool and iterators and references into that side are invalidated. At most min(at, size() - at) moves.
+    _NODISCARD constexpr List split_at(Iterator at) {
+        // no pool of its own yet, _hand_off gives it one
+        List rest(allocator.get_resource(), 0);
+        _hand_off(at, rest);
+        return rest;
+    }
+
+    // elements not satisfying predicate are appended to out, returns how many.
+    // The partition itself relinks, the hand-off to out moves elements like split_at does:
+    // the kept elements when out is empty and they are fewer, the appended ones otherwise.
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    constexpr size_t partition_into(List& out, Predicate&& predicate) {
+        size_t before = length;
+        _hand_off(stable_partition(std::forward<Predicate>(predicate)), out);
+        return before - length;
+    }
+
+    // LSD radix sort on an integral or floating point key, 11 bits per pass (3 passes for 32 bit keys).
+    // Nodes are distributed into bucket chains by relinking next and the chains joined back,
+    // no element is moved or compared; digits that are equal in every key are skipped after the first pass.
+    // Stable, and unlike sort() equal keys are kept.
+    template <typename KeyExtractor = std::identity>
+    requires _radix_key<std::remove_cvref_t<std::invoke_result_t<KeyExtractor, Visible>>>
+    constexpr void radix_sort(KeyExtractor&& key = KeyExtractor{}) noexcept(
+        std::is_nothrow_invocable_v<KeyExtractor, Visible>)
+    {
+        using Key = std::remove_cvref_t<std::invoke_result_t<KeyExtractor, Visible>>;
+        using Bits = decltype(_radix_bits(Key{}));
+
+        constexpr size_t digit_bits = 11;
+        constexpr size_t buckets = size_t{1} << digit_bits;
+        // wider than an 8 or 16 bit Bits, digits are taken as size_t
+        constexpr size_t digit_mask = buckets - 1;
+
+        if (length < 2) return;
+
+        // 2 x 2048 pointers, too much for the stack of a caller deep in recursion or on a small thread
+        std::vector<Node*> bucket_heads(buckets);
+        std::vector<Node*> bucket_tails(buckets);
+
+        Bits all_and = static_cast<Bits>(~Bits{0});
+        Bits all_or = 0;
+
+        for (size_t shift = 0; shift < sizeof(Bits) * 8; shift += digit_bits) {
+            // the first pass also finds which digits vary at all
+            if (shift != 0 && (static_cast<size_t>((all_and ^ all_or) >> shift) & digit_mask) == 0) continue;
+
+            if (shift != 0) {
+                std::fill(bucket_heads.begin(), bucket_heads.end(), nullptr);
+                std::fill(bucket_tails.begin(), bucket_tails.end(), nullptr);
+            }
+
+            for (Node* current = head; current != nullptr;) {
+                Node* next = current->next;
+                Bits bits = _radix_bits(static_cast<Key>(key(_visible(current))));
+
+                if (shift == 0) {
+                    all_and &= bits;
+                    all_or |= bits;
+                }
+
+                size_t digit = static_cast<size_t>(bits >> shift) & digit_mask;
+                _append_node(bucket_heads[digit], bucket_tails[digit], current);
+                current = next;
+            }
+
+            Node* last = nullptr;
+
+            for (size_t digit = 0; digit < buckets; ++digit) {
+                if (!bucket_heads[digit]) continue;
+
+                if (last) last->next = bucket_heads[digit];
+                else head = bucket_heads[digit];
+
+                last = bucket_tails[digit];
+            }
+            tail = last;
+        }
+        _rehash();
     }
 
     template <typename SortMethod = std::less<T>> // also make merge sort sometime
@@ -812,15 +1747,32 @@ public:
         { left < right } -> std::convertible_to<bool>;
     }
     {
-        std::set<T, SortMethod> sorted;
+        if (!head) return;
 
-        Node* current = head;
+        if consteval {
+            // std::set is not usable in constant evaluation, same result through a vector
+            std::vector<T> sorted;
 
-        while (current) {
-            sorted.insert(current->element);
-            current = current->next;
+            for (Node* current = head; current; current = current->next) {
+                sorted.push_back(current->value());
+            }
+            std::sort(sorted.begin(), sorted.end(), sort_method);
+            sorted.erase(std::unique(sorted.begin(), sorted.end(), [&](const T& left, const T& right) {
+                return !sort_method(left, right) && !sort_method(right, left);
+            }), sorted.end());
+
+            assign(sorted.begin(), sorted.end());
+        } else {
+            std::set<T, SortMethod> sorted;
+
+            Node* current = head;
+
+            while (current) {
+                sorted.insert(current->value());
+                current = current->next;
+            }
+            assign(sorted.begin(), sorted.end());
         }
-        assign(sorted.begin(), sorted.end());
     }
 
     constexpr bool operator == (const List& other) const noexcept 
@@ -831,6 +1783,11 @@ public:
         if (length != other.length) 
             return false;
 
+        if constexpr (hashed) {
+            if (content_hash != other.content_hash)
+                return false;
+        }
+
         return &_compare<'='>(other) == this;
     }
 
@@ -839,7 +1796,7 @@ public:
         { left != right } -> std::convertible_to<bool>;
     }
     {
-        return &_compare<'='>(other) != this;
+        return !(*this == other);
     }
 
     constexpr bool operator > (const List& other) const noexcept
@@ -858,22 +1815,32 @@ public:
         return &_compare<'<'>(other) == this;
     }
 
-    constexpr List operator + (const List& other) noexcept {
-        List temp(length + other.length + 1);
-
-        temp._insert_range(length, temp.begin(), head, tail);
-        temp._insert_range(other.length, temp.end(), other.head, other.tail);
+    constexpr List operator + (const List& other) const noexcept {
+        List temp(*this);
+        temp += other;
+        return temp;
     }
 
     constexpr List& operator += (const List& other) noexcept {
-        _confirm_avail_mem(length + other.length + 1);
-        _insert_range(other.length, end(), other.head, other.tail);
+        _confirm_avail_mem(other.length);
+
+        // other may be *this, stop at its current tail
+        for (Node* current = other.head, *last = other.tail; current != nullptr; current = current->next) {
+            insert_back(current->value());
+            if (current == last) break;
+        }
+        return *this;
     }
 
     constexpr size_t size() const {
         return length;
     }
 
+    // equal lists hash equal; usable as a cache key without walking the list
+    _NODISCARD constexpr size_t hash() const noexcept requires hashed {
+        return static_cast<size_t>(_mix(content_hash.sum ^ _mix(length)));
+    }
+
     constexpr bool empty() const {
         return length;
     }
@@ -891,11 +1858,19 @@ public:
     }
 
     constexpr decltype(auto) front(this auto&& self) noexcept {
-        return std::forward<decltype(self)>(self)->head->element;
+        if constexpr (hashed) {
+            return std::as_const(self.head->value());
+        } else {
+            return std::forward<decltype(self)>(self).head->value();
+        }
     }
 
     constexpr decltype(auto) back(this auto&& self) noexcept {
-        return std::forward<decltype(self)>(self)->tail->element;
+        if constexpr (hashed) {
+            return std::as_const(self.tail->value());
+        } else {
+            return std::forward<decltype(self)>(self).tail->value();
+        }
     }
 
     constexpr const auto& get_allocator() const {
@@ -903,84 +1878,4019 @@ public:
     }
 };
 
+template <typename T, size_t Capacity, NodeLayout Layout>
+struct std::hash<List<T, Capacity, Layout, Hashing::Content>> {
+    size_t operator()(const List<T, Capacity, Layout, Hashing::Content>& list) const noexcept {
+        return list.hash();
+    }
+};
+
+// List with a value -> node index kept in sync on every mutation.
+// find / contains / count / remove(value) are expected O(1) (remove is O(matches)), order is still insertion order.
+// Every insert is O(1): a node joins its chain of equal elements next to an equal list neighbour, at the matching
+// end when inserted at either end of the list, otherwise at the back of the chain. So find returns the first equal
+// element in list order, as List::find does, unless a duplicate was inserted in the middle away from any equal
+// element; from then on it may return a later one, until sort() rebuilds the chains.
+// Elements are only reachable as const, writing through an iterator would desync the index.
+template <typename T, size_t Capacity = 24>
+class IndexedList {
+public:
+    class Iterator;
+
+private:
+    struct Node {
+        T element;
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        // chain of nodes holding an equal element, in list order unless a middle insert put one at the back
+        Node* same_prev = nullptr;
+        Node* same_next = nullptr;
+
+        template <typename _T>
+        requires std::is_convertible_v<_T, T>
+        constexpr Node(_T&& element) : element(std::forward<_T>(element)) {}
+    };
+
+    struct Bucket {
+        Node* first = nullptr;
+        Node* last = nullptr;
+        size_t count = 0;
+    };
 
+    NodeAllocator<Node, Capacity> allocator;
+    std::unordered_map<T, Bucket> index;
 
+    Node* head = nullptr;
+    Node* tail = nullptr;
 
-template <size_t MultiplyFactor>
-struct NumberGenerator {
-    int x = 1;
+    size_t length = 0;
 
-    int operator ()() {
-        return x *= MultiplyFactor;
+    void _chain(Bucket& bucket, Node* node, Node* after) noexcept {
+        node->same_prev = after;
+        node->same_next = after ? after->same_next : bucket.first;
+
+        if (node->same_prev) node->same_prev->same_next = node;
+        else bucket.first = node;
+
+        if (node->same_next) node->same_next->same_prev = node;
+        else bucket.last = node;
+
+        bucket.count++;
     }
-};
 
-int main() {
-    auto start = std::chrono::high_resolution_clock::now();
+    // node is already linked. Its chain position is only looked up where it takes no walk:
+    // at either end of the list or next to an equal neighbour. Anywhere else it joins the back of the chain
+    void _index(Node* node) {
+        Bucket& bucket = index[node->element];
+        Node* after = nullptr;
+
+        if (bucket.count == 0 || !node->prev) {
+            // first in its chain
+        } else if (!node->next) {
+            after = bucket.last;
+        } else if (node->prev->element == node->element) {
+            after = node->prev;
+        } else if (node->next->element == node->element) {
+            after = node->next->same_prev;
+        } else {
+            after = bucket.last;
+        }
+        _chain(bucket, node, after);
+    }
 
-    List<int, 10> list;
-    int i = 0;
+    void _unindex(Node* node) noexcept {
+        auto it = index.find(node->element);
+        Bucket& bucket = it->second;
 
+        if (node->same_prev) node->same_prev->same_next = node->same_next;
+        else bucket.first = node->same_next;
 
-    auto print = [](auto&&v){
-        std::cout << v << std::endl;
-    };
+        if (node->same_next) node->same_next->same_prev = node->same_prev;
+        else bucket.last = node->same_prev;
 
-  //  list.for_each([](auto&&val){ std::cout << val << std::endl;});
+        if (--bucket.count == 0) {
+            index.erase(it);
+        }
+    }
 
-  //  list.insert_back(3);
- //   list.insert_back(3);
-  //  list.assign(5, 5);
+    void _link(Node* node, Node* before) noexcept {
+        node->next = before;
+        node->prev = before ? before->prev : tail;
 
-    list.insert_range(list.begin(), 11, NumberGenerator<2>{});
-    list.erase(list.begin() + 5);
+        if (node->prev) node->prev->next = node;
+        else head = node;
 
-    list.insert_back(65);
-    list.insert_back(66);
-    list.erase_range(list.begin(), list.begin() + 3);
-    list.assign(5, NumberGenerator<2>{});
-    list.insert_range(list.begin() + 2, 5,6,7);
-    list.insert_front(5);
-    list.insert_back(10);
-    list.erase(list.begin() + 1);
-    list.remove_if([](auto&&v){return false;});
-    auto it = list.find_if([](auto&&v){return false;});
-    list.unique_all();
+        if (before) before->prev = node;
+        else tail = node;
 
-    auto n = list.filter([](auto&&v){
-        return v % 2 == 0;
-    });
+        length++;
+    }
 
-    n.for_each(print);
+    void _unlink(Node* node) noexcept {
+        if (node->prev) node->prev->next = node->next;
+        else head = node->next;
 
+        if (node->next) node->next->prev = node->prev;
+        else tail = node->prev;
 
+        length--;
+    }
 
-    std::cout << "-" << std::endl << std::endl;
-    list.sort();
-    list.for_each(print);
+    void _destroy(Node* node) noexcept {
+        _unindex(node);
+        _unlink(node);
+        allocator.deallocate(node, 1);
+    }
 
-    auto f = n;
-    std::cout << "-" << std::endl << std::endl;
-   // f.for_each(print);
+    void _resize(size_t new_capacity) {
+        NodeAllocator<Node, Capacity> new_allocator(new_capacity);
 
-    if (n == f) {
-        std::cout << "n==list\n";
+        Node* current = head;
+        head = tail = nullptr;
+        length = 0;
+        index.clear();
+
+        while (current != nullptr) {
+            Node* node = std::construct_at(new_allocator.allocate(1), std::move(current->element));
+            _link(node, nullptr);
+            _index(node);
+            current = current->next;
+        }
+        allocator = std::move(new_allocator);
     }
 
-    if (list > n) {
-        std::cout << "LIST > N\n";
+    size_t _distance(Iterator at) const noexcept {
+        size_t distance = 0;
+
+        for (Node* current = head; current != at.current; current = current->next) {
+            distance++;
+        }
+        return distance;
     }
 
-    if (n > list) {
-        std::cout << "N > LIST\n";
+    void _confirm_avail_mem(size_t n) {
+        if (n + length > allocator.get_capacity()) {
+            _resize(allocator.get_capacity() * 1.5 + n);
+        }
     }
 
-    if (n < list) {
-        std::cout << "N < LIST\n";
+    void _confirm_avail_mem(size_t n, Iterator& at) {
+        if (n + length > allocator.get_capacity()) {
+            size_t distance = _distance(at);
+            _resize(allocator.get_capacity() * 1.5 + n);
+            at = begin() + distance;
+        }
     }
 
-    if (list < n) {
-        std::cout << "LIST < N\n";
+    template <typename _T>
+    Iterator _emplace(Node* before, _T&& element) {
+        Node* node = std::construct_at(allocator.allocate(1), std::forward<_T>(element));
+
+        _link(node, before);
+        _index(node);
+
+        return Iterator(node);
+    }
+
+public:
+    class Iterator {
+    friend class IndexedList<T, Capacity>;
+        Node* current;
+
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr Iterator() : current(nullptr) {}
+        constexpr explicit Iterator(Node* current) : current(current) {}
+
+        constexpr Iterator& operator ++ () {
+            current = current->next;
+            return *this;
+        }
+
+        constexpr Iterator operator ++ (int) {
+            Iterator temp = *this;
+            current = current->next;
+            return temp;
+        }
+
+        constexpr Iterator operator + (int increment) const {
+            Node* it = current;
+
+            for (int i = 0; i < increment; ++i) {
+                it = it->next;
+            }
+            return Iterator(it);
+        }
+
+        constexpr const T& operator * () const {
+            return current->element;
+        }
+
+        constexpr const T* operator -> () const {
+            return &current->element;
+        }
+
+        constexpr bool operator == (const Iterator& other) const {
+            return current == other.current;
+        }
+
+        constexpr bool operator != (const Iterator& other) const {
+            return current != other.current;
+        }
+
+        constexpr bool operator == (std::nullptr_t) const {
+            return current == nullptr;
+        }
+
+        constexpr bool operator != (std::nullptr_t) const {
+            return current != nullptr;
+        }
+    };
+
+    explicit IndexedList(size_t capacity = Capacity) : allocator(capacity) {}
+
+    template <typename InputIterator>
+    IndexedList(InputIterator first, InputIterator last) : allocator(Capacity + std::distance(first, last)) {
+        insert_range(end(), first, last);
+    }
+
+    IndexedList(std::initializer_list<T> ini_list) : IndexedList(ini_list.begin(), ini_list.end()) {}
+
+    IndexedList(const IndexedList& other) : allocator(other.allocator.get_capacity()) {
+        insert_range(end(), other.begin(), other.end());
+    }
+
+    IndexedList& operator = (const IndexedList& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    IndexedList(IndexedList&& other) noexcept
+        : allocator(std::move(other.allocator)), index(std::move(other.index)),
+          head(other.head), tail(other.tail), length(other.length)
+    {
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.length = 0;
+    }
+
+    IndexedList& operator = (IndexedList&& other) noexcept {
+        if (this != &other) {
+            allocator = std::move(other.allocator);
+            index = std::move(other.index);
+            head = other.head;
+            tail = other.tail;
+            length = other.length;
+
+            other.head = nullptr;
+            other.tail = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+
+    ~IndexedList() noexcept {
+        clear();
+    }
+
+    void reserve(size_t elements) {
+        if (allocator.get_capacity() < elements)
+            _resize(elements);
+    }
+
+    T_Convertible Iterator insert_front(_T&& element) {
+        _confirm_avail_mem(1);
+        return _emplace(head, std::forward<_T>(element));
+    }
+
+    T_Convertible Iterator insert_back(_T&& element) {
+        _confirm_avail_mem(1);
+        return _emplace(nullptr, std::forward<_T>(element));
+    }
+
+    // inserts before at, returns the inserted element
+    T_Convertible Iterator insert(Iterator at, _T&& element) {
+        _confirm_avail_mem(1, at);
+        return _emplace(at.current, std::forward<_T>(element));
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    Iterator insert_range(Iterator at, Range first, Range last) {
+        _confirm_avail_mem(std::distance(first, last), at);
+
+        for (Range it = first; it != last; ++it) {
+            _emplace(at.current, *it);
+        }
+        return at;
+    }
+
+    Iterator pop_front() noexcept {
+        _destroy(head);
+        return begin();
+    }
+
+    Iterator pop_back() noexcept {
+        _destroy(tail);
+        return end();
+    }
+
+    Iterator erase(Iterator at) noexcept {
+        Node* next = at.current->next;
+        _destroy(at.current);
+        return Iterator(next);
+    }
+
+    Iterator erase_range(Iterator from, Iterator to) noexcept {
+        while (from != to) {
+            from = erase(from);
+        }
+        return to;
+    }
+
+    Iterator erase_range(Iterator from) noexcept {
+        return erase_range(from, end());
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    void assign(Range first, Range last) {
+        clear();
+        insert_range(end(), first, last);
+    }
+
+    T_Convertible void assign(size_t n, _T&& val) {
+        clear();
+        _confirm_avail_mem(n);
+
+        for (size_t i = 0; i < n; ++i) {
+            _emplace(nullptr, val);
+        }
+    }
+
+    void assign(std::initializer_list<T> ini_list) {
+        assign(ini_list.begin(), ini_list.end());
+    }
+
+    void clear() noexcept {
+        while (head != nullptr) {
+            Node* temp = head;
+            head = head->next;
+            allocator.deallocate(temp, 1);
+        }
+        tail = nullptr;
+        length = 0;
+        index.clear();
+    }
+
+    // with duplicates, the head of the chain: the first occurrence in list order, as List::find,
+    // unless a duplicate was inserted in the middle away from any equal element, see the class comment
+    _NODISCARD Iterator find(const T& to_find) const noexcept {
+        auto it = index.find(to_find);
+        return it == index.end() ? end() : Iterator(it->second.first);
+    }
+
+    _NODISCARD bool contains(const T& value) const noexcept {
+        return index.contains(value);
+    }
+
+    _NODISCARD size_t count(const T& value) const noexcept {
+        auto it = index.find(value);
+        return it == index.end() ? 0 : it->second.count;
+    }
+
+    // returns the number of removed elements
+    size_t remove(const T& to_remove) noexcept {
+        auto it = index.find(to_remove);
+
+        if (it == index.end()) return 0;
+
+        size_t removed = it->second.count;
+
+        for (Node* node = it->second.first; node != nullptr;) {
+            Node* next = node->same_next;
+            _unlink(node);
+            allocator.deallocate(node, 1);
+            node = next;
+        }
+        index.erase(it);
+
+        return removed;
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    _NODISCARD Iterator find_if(Predicate&& predicate) const noexcept(
+        std::is_nothrow_invocable_r_v<bool, Predicate, T>)
+    {
+        for (Node* current = head; current != nullptr; current = current->next) {
+            if (predicate(current->element)) {
+                return Iterator(current);
+            }
+        }
+        return end();
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    void remove_if(Predicate&& predicate) noexcept(
+        std::is_nothrow_invocable_r_v<bool, Predicate, T>)
+    {
+        for (Node* current = head; current != nullptr;) {
+            Node* next = current->next;
+
+            if (predicate(current->element)) {
+                _destroy(current);
+            }
+            current = next;
+        }
+    }
+
+    template <typename Predicate>
+    requires std::is_invocable_v<Predicate, const T&>
+    void for_each(Predicate&& predicate) const noexcept(
+        std::is_nothrow_invocable_v<Predicate, const T&>)
+    {
+        for (Node* current = head; current != nullptr; current = current->next) {
+            predicate(std::as_const(current->element));
+        }
+    }
+
+    // like List::sort, an element equivalent to an earlier one is removed, the first occurrence stays.
+    // Relinks nodes instead of moving elements, then rebuilds the chains in the new order
+    template <typename SortMethod = std::less<T>>
+    void sort(SortMethod&& sort_method = SortMethod{}) {
+        std::vector<Node*> nodes;
+        nodes.reserve(length);
+
+        for (Node* current = head; current != nullptr; current = current->next) {
+            nodes.push_back(current);
+        }
+
+        std::stable_sort(nodes.begin(), nodes.end(), [&](const Node* left, const Node* right) {
+            return sort_method(left->element, right->element);
+        });
+
+        head = tail = nullptr;
+        length = 0;
+
+        for (Node* node : nodes) {
+            _link(node, nullptr);
+        }
+
+        for (Node* current = head; current != nullptr && current->next != nullptr;) {
+            Node* next = current->next;
+
+            if (!sort_method(current->element, next->element) && !sort_method(next->element, current->element)) {
+                _destroy(next);
+            } else {
+                current = next;
+            }
+        }
+
+        for (auto& [value, bucket] : index) {
+            bucket = Bucket{};
+        }
+        for (Node* current = head; current != nullptr; current = current->next) {
+            Bucket& bucket = index.find(current->element)->second;
+            _chain(bucket, current, bucket.last);
+        }
+    }
+
+    bool operator == (const IndexedList& other) const noexcept {
+        if (length != other.length)
+            return false;
+
+        return std::equal(begin(), end(), other.begin());
+    }
+
+    constexpr size_t size() const noexcept {
+        return length;
+    }
+
+    constexpr bool empty() const noexcept {
+        return length == 0;
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return allocator.get_capacity();
+    }
+
+    constexpr Iterator begin() const noexcept {
+        return Iterator(head);
+    }
+
+    constexpr Iterator end() const noexcept {
+        return Iterator(nullptr);
+    }
+
+    constexpr const T& front() const noexcept {
+        return head->element;
+    }
+
+    constexpr const T& back() const noexcept {
+        return tail->element;
+    }
+};
+
+// Grows by adding NodeAllocator blocks instead of rebuilding, so handed out pointers stay valid.
+template <typename T, size_t Capacity>
+class ChunkedNodeAllocator {
+    std::vector<NodeAllocator<T, Capacity>> chunks;
+
+public:
+    using value_type = T;
+
+    ChunkedNodeAllocator() = default;
+
+    ChunkedNodeAllocator(const ChunkedNodeAllocator&) = delete;
+    ChunkedNodeAllocator& operator=(const ChunkedNodeAllocator&) = delete;
+
+    ChunkedNodeAllocator(ChunkedNodeAllocator&&) noexcept = default;
+    ChunkedNodeAllocator& operator=(ChunkedNodeAllocator&&) noexcept = default;
+
+    // chunks double in size, so there are O(log n) of them to look through
+    T* allocate(size_t) {
+        for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+            if (!it->full()) {
+                return it->allocate(1);
+            }
+        }
+        chunks.emplace_back(chunks.empty() ? Capacity : chunks.back().get_capacity() * 2);
+        return chunks.back().allocate(1);
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+            if (it->owns(ptr)) {
+                it->deallocate(ptr, 1);
+                return;
+            }
+        }
+    }
+
+    size_t get_capacity() const noexcept {
+        size_t capacity = 0;
+
+        for (const auto& chunk : chunks) {
+            capacity += chunk.get_capacity();
+        }
+        return capacity;
+    }
+
+    void clear() noexcept {
+        chunks.clear();
+    }
+};
+
+// Ordered list on a skip list: O(log n) expected insert / find / lower_bound / erase, O(k) range scans.
+// Iteration is the same forward walk as List; elements are const since their position depends on them.
+// Where the List API takes a position or an order, Compare decides instead: insert / insert_range ignore the
+// position, sort ignores its argument and keeps equal elements, and insert_range returns nothing since
+// the inserted elements are not contiguous.
+template <typename T, size_t Capacity = 24, typename Compare = std::less<T>>
+class SortedList {
+public:
+    class Iterator;
+
+private:
+    static constexpr size_t MaxLevel = 16;
+
+    struct Node;
+    using Tower = std::array<Node*, MaxLevel - 1>;
+
+    struct Node {
+        T element;
+        Node* next = nullptr;
+        // levels 1.. only exist for nodes taller than 1 (about a quarter of them)
+        Tower* tower = nullptr;
+        size_t height = 1;
+
+        template <typename _T>
+        requires std::is_convertible_v<_T, T>
+        constexpr Node(_T&& element) : element(std::forward<_T>(element)) {}
+    };
+
+    ChunkedNodeAllocator<Node, Capacity> allocator;
+    ChunkedNodeAllocator<Tower, Capacity / 4 + 1> towers;
+
+    std::array<Node*, MaxLevel> head{};
+    Node* tail = nullptr;
+
+    size_t level = 1;
+    size_t length = 0;
+
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+
+    Compare compare;
+
+    Node*& _forward(Node* node, size_t i) noexcept {
+        if (!node) return head[i];
+        if (i == 0) return node->next;
+        return (*node->tower)[i - 1];
+    }
+
+    // p = 1/4 per extra level
+    size_t _random_height() noexcept {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        uint64_t bits = seed;
+        size_t height = 1;
+
+        while (height < MaxLevel && (bits & 3) == 0) {
+            height++;
+            bits >>= 2;
+        }
+        return height;
+    }
+
+    // fills preds with the last node before value on every level, nullptr being the head
+    template <bool Upper>
+    Node* _search(const T& value, std::array<Node*, MaxLevel>& preds) noexcept {
+        Node* x = nullptr;
+
+        for (size_t i = level; i-- > 0;) {
+            for (Node* n = _forward(x, i); n != nullptr; n = _forward(x, i)) {
+                bool before = Upper ? !compare(value, n->element) : compare(n->element, value);
+                if (!before) break;
+                x = n;
+            }
+            preds[i] = x;
+        }
+        return _forward(x, 0);
+    }
+
+    template <bool Upper>
+    Node* _search(const T& value) const noexcept {
+        std::array<Node*, MaxLevel> preds;
+        return const_cast<SortedList*>(this)->template _search<Upper>(value, preds);
+    }
+
+    Node* _make_node(auto&& element) {
+        Node* node = std::construct_at(allocator.allocate(1), std::forward<decltype(element)>(element));
+        node->height = _random_height();
+
+        if (node->height > 1) {
+            node->tower = std::construct_at(towers.allocate(1));
+        }
+        return node;
+    }
+
+    void _free_node(Node* node) noexcept {
+        if (node->tower) {
+            towers.deallocate(node->tower, 1);
+        }
+        allocator.deallocate(node, 1);
+    }
+
+    Node* _link(Node* node, std::array<Node*, MaxLevel>& preds) noexcept {
+        for (; level < node->height; ++level) {
+            preds[level] = nullptr;
+        }
+
+        for (size_t i = 0; i < node->height; ++i) {
+            _forward(node, i) = _forward(preds[i], i);
+            _forward(preds[i], i) = node;
+        }
+
+        if (!node->next) tail = node;
+
+        length++;
+        return node;
+    }
+
+    void _unlink(Node* node) noexcept {
+        Node* x = nullptr;
+
+        for (size_t i = level; i-- > 0;) {
+            for (Node* n = _forward(x, i); n != nullptr && compare(n->element, node->element); n = _forward(x, i)) {
+                x = n;
+            }
+
+            if (i < node->height) {
+                // skip equivalent elements until the node itself
+                while (_forward(x, i) != node) {
+                    x = _forward(x, i);
+                }
+                _forward(x, i) = _forward(node, i);
+            }
+        }
+
+        if (node == tail) tail = x;
+
+        while (level > 1 && head[level - 1] == nullptr) {
+            level--;
+        }
+        length--;
+    }
+
+public:
+    class Iterator {
+    friend class SortedList<T, Capacity, Compare>;
+        Node* current;
+
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr Iterator() : current(nullptr) {}
+        constexpr explicit Iterator(Node* current) : current(current) {}
+
+        constexpr Iterator& operator ++ () {
+            current = current->next;
+            return *this;
+        }
+
+        constexpr Iterator operator ++ (int) {
+            Iterator temp = *this;
+            current = current->next;
+            return temp;
+        }
+
+        constexpr Iterator operator + (int increment) const {
+            Node* it = current;
+
+            for (int i = 0; i < increment; ++i) {
+                it = it->next;
+            }
+            return Iterator(it);
+        }
+
+        constexpr const T& operator * () const {
+            return current->element;
+        }
+
+        constexpr const T* operator -> () const {
+            return &current->element;
+        }
+
+        constexpr bool operator == (const Iterator& other) const {
+            return current == other.current;
+        }
+
+        constexpr bool operator != (const Iterator& other) const {
+            return current != other.current;
+        }
+
+        constexpr bool operator == (std::nullptr_t) const {
+            return current == nullptr;
+        }
+
+        constexpr bool operator != (std::nullptr_t) const {
+            return current != nullptr;
+        }
+    };
+
+    explicit SortedList(Compare compare = Compare{}) : compare(std::move(compare)) {}
+
+    template <typename InputIterator>
+    SortedList(InputIterator first, InputIterator last, Compare compare = Compare{}) : compare(std::move(compare)) {
+        insert_range(first, last);
+    }
+
+    SortedList(std::initializer_list<T> ini_list, Compare compare = Compare{}) : SortedList(ini_list.begin(), ini_list.end(), std::move(compare)) {}
+
+    // already in order, appended level by level in O(n)
+    SortedList(const SortedList& other) : compare(other.compare) {
+        std::array<Node*, MaxLevel> last{};
+
+        for (const T& element : other) {
+            _link(_make_node(element), last);
+
+            for (size_t i = 0; i < tail->height; ++i) {
+                last[i] = tail;
+            }
+        }
+    }
+
+    SortedList& operator = (const SortedList& other) {
+        if (this != &other) {
+            SortedList temp(other);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    SortedList(SortedList&& other) noexcept
+        : allocator(std::move(other.allocator)), towers(std::move(other.towers)),
+          head(other.head), tail(other.tail), level(other.level), length(other.length),
+          seed(other.seed), compare(std::move(other.compare))
+    {
+        other.head = {};
+        other.tail = nullptr;
+        other.level = 1;
+        other.length = 0;
+    }
+
+    SortedList& operator = (SortedList&& other) noexcept {
+        if (this != &other) {
+            allocator = std::move(other.allocator);
+            towers = std::move(other.towers);
+            head = other.head;
+            tail = other.tail;
+            level = other.level;
+            length = other.length;
+            seed = other.seed;
+            compare = std::move(other.compare);
+
+            other.head = {};
+            other.tail = nullptr;
+            other.level = 1;
+            other.length = 0;
+        }
+        return *this;
+    }
+
+    ~SortedList() noexcept {
+        clear();
+    }
+
+    // equivalent elements keep their insertion order
+    T_Convertible Iterator insert(_T&& element) {
+        std::array<Node*, MaxLevel> preds;
+        _search<true>(element, preds);
+
+        return Iterator(_link(_make_node(std::forward<_T>(element)), preds));
+    }
+
+    // position is decided by Compare, these only keep List call sites compiling unchanged
+    T_Convertible Iterator insert_back(_T&& element) {
+        return insert(std::forward<_T>(element));
+    }
+
+    T_Convertible Iterator insert_front(_T&& element) {
+        return insert(std::forward<_T>(element));
+    }
+
+    T_Convertible Iterator insert(Iterator, _T&& element) {
+        return insert(std::forward<_T>(element));
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    void insert_range(Range first, Range last) {
+        for (Range it = first; it != last; ++it) {
+            insert(*it);
+        }
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    void insert_range(Iterator, Range first, Range last) {
+        insert_range(first, last);
+    }
+
+    template <typename Iteratable>
+    void insert_range(Iterator, Iteratable&& container)
+    requires requires {
+        { std::begin(container) };
+        { std::end(container) };
+    }
+    {
+        insert_range(std::begin(container), std::end(container));
+    }
+
+    template <typename Generator>
+    requires std::is_convertible_v<std::invoke_result_t<Generator>, T>
+    void insert_range(Iterator, size_t n, Generator&& gen) {
+        for (size_t i = 0; i < n; ++i) {
+            insert(gen());
+        }
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    void assign(Range first, Range last) {
+        clear();
+        insert_range(first, last);
+    }
+
+    // always sorted by Compare, kept for List call sites. Unlike List::sort, equal elements stay
+    template <typename SortMethod = Compare>
+    constexpr void sort(SortMethod&& = SortMethod{}) const noexcept {}
+
+    Iterator erase(Iterator at) noexcept {
+        Node* next = at.current->next;
+
+        _unlink(at.current);
+        _free_node(at.current);
+
+        return Iterator(next);
+    }
+
+    Iterator erase_range(Iterator from, Iterator to) noexcept {
+        while (from != to) {
+            from = erase(from);
+        }
+        return to;
+    }
+
+    // returns the number of removed elements
+    size_t remove(const T& to_remove) noexcept {
+        size_t removed = 0;
+
+        for (Iterator it = lower_bound(to_remove); it != end() && !compare(to_remove, *it); ++removed) {
+            it = erase(it);
+        }
+        return removed;
+    }
+
+    size_t erase(const T& to_remove) noexcept {
+        return remove(to_remove);
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    void remove_if(Predicate&& predicate) noexcept(
+        std::is_nothrow_invocable_r_v<bool, Predicate, T>)
+    {
+        for (Iterator it = begin(); it != end();) {
+            if (predicate(*it)) {
+                it = erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    Iterator pop_front() noexcept {
+        return erase(begin());
+    }
+
+    Iterator pop_back() noexcept {
+        erase(Iterator(tail));
+        return end();
+    }
+
+    void unique() noexcept {
+        for (Iterator it = begin(); it != end();) {
+            Iterator next = it + 1;
+
+            if (next != end() && !compare(*it, *next)) {
+                erase(next);
+            } else {
+                it = next;
+            }
+        }
+    }
+
+    void clear() noexcept {
+        for (Node* current = head[0]; current != nullptr;) {
+            Node* next = current->next;
+            _free_node(current);
+            current = next;
+        }
+        head = {};
+        tail = nullptr;
+        level = 1;
+        length = 0;
+    }
+
+    _NODISCARD Iterator lower_bound(const T& value) const noexcept {
+        return Iterator(_search<false>(value));
+    }
+
+    _NODISCARD Iterator upper_bound(const T& value) const noexcept {
+        return Iterator(_search<true>(value));
+    }
+
+    _NODISCARD Iterator find(const T& to_find) const noexcept {
+        Iterator it = lower_bound(to_find);
+
+        if (it != end() && !compare(to_find, *it)) {
+            return it;
+        }
+        return end();
+    }
+
+    _NODISCARD bool contains(const T& value) const noexcept {
+        return find(value) != end();
+    }
+
+    _NODISCARD size_t count(const T& value) const noexcept {
+        size_t n = 0;
+
+        for (Iterator it = lower_bound(value); it != end() && !compare(value, *it); ++it) {
+            n++;
+        }
+        return n;
+    }
+
+    // elements in [from, to)
+    _NODISCARD auto range(const T& from, const T& to) const noexcept {
+        return std::ranges::subrange<Iterator>(lower_bound(from), lower_bound(to));
+    }
+
+    _NODISCARD auto equal_range(const T& value) const noexcept {
+        return std::ranges::subrange<Iterator>(lower_bound(value), upper_bound(value));
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    _NODISCARD Iterator find_if(Predicate&& predicate) const noexcept(
+        std::is_nothrow_invocable_r_v<bool, Predicate, T>)
+    {
+        for (Iterator it = begin(); it != end(); ++it) {
+            if (predicate(*it)) {
+                return it;
+            }
+        }
+        return end();
+    }
+
+    template <typename Predicate>
+    requires std::is_invocable_v<Predicate, const T&>
+    void for_each(Predicate&& predicate) const noexcept(
+        std::is_nothrow_invocable_v<Predicate, const T&>)
+    {
+        for (Iterator it = begin(); it != end(); ++it) {
+            predicate(*it);
+        }
+    }
+
+    bool operator == (const SortedList& other) const noexcept {
+        if (length != other.length)
+            return false;
+
+        return std::equal(begin(), end(), other.begin());
+    }
+
+    constexpr size_t size() const noexcept {
+        return length;
+    }
+
+    constexpr bool empty() const noexcept {
+        return length == 0;
+    }
+
+    size_t capacity() const noexcept {
+        return allocator.get_capacity();
+    }
+
+    constexpr Iterator begin() const noexcept {
+        return Iterator(head[0]);
+    }
+
+    constexpr Iterator end() const noexcept {
+        return Iterator(nullptr);
+    }
+
+    constexpr const T& front() const noexcept {
+        return head[0]->element;
+    }
+
+    constexpr const T& back() const noexcept {
+        return tail->element;
+    }
+};
+
+// Many small lists sharing one structure-of-arrays node pool. A list is only a head/tail/length triple,
+// links and payloads live in two parallel arrays indexed by slot, free slots are chained through the links.
+template <typename T, typename Index = uint32_t>
+class ListArena {
+public:
+    static constexpr Index npos = static_cast<Index>(-1);
+
+    struct Handle {
+        Index head = npos;
+        Index tail = npos;
+        Index length = 0;
+    };
+
+    class Iterator {
+    friend class ListArena<T, Index>;
+        ListArena* arena;
+        Index current;
+
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr Iterator() : arena(nullptr), current(npos) {}
+        constexpr explicit Iterator(ListArena* arena, Index current) : arena(arena), current(current) {}
+
+        constexpr Iterator& operator ++ () {
+            current = arena->links[current];
+            return *this;
+        }
+
+        constexpr Iterator operator ++ (int) {
+            Iterator temp = *this;
+            current = arena->links[current];
+            return temp;
+        }
+
+        constexpr T& operator * () const {
+            return arena->values[current];
+        }
+
+        constexpr bool operator == (const Iterator& other) const {
+            return current == other.current;
+        }
+
+        constexpr bool operator != (const Iterator& other) const {
+            return current != other.current;
+        }
+    };
+
+private:
+    // npos marks the end of a chain, so it can never be a slot
+    static constexpr size_t max_slots = static_cast<size_t>(npos);
+
+    std::vector<Index> links;
+    // raw storage parallel to links, a slot holds a constructed T only while a list links it
+    T* values = nullptr;
+    size_t value_capacity = 0;
+    std::vector<Handle> lists;
+
+    Index free_head = npos;
+    size_t free_count = 0;
+
+    std::vector<bool> _free_slots() const {
+        std::vector<bool> free(links.size());
+
+        for (Index slot = free_head; slot != npos; slot = links[slot]) {
+            free[slot] = true;
+        }
+        return free;
+    }
+
+    // moves every element to new storage, each keeps its slot
+    void _relocate(size_t new_capacity) {
+        links.reserve(new_capacity);
+
+        T* storage = std::allocator<T>{}.allocate(new_capacity);
+        std::vector<bool> free = _free_slots();
+
+        for (size_t slot = 0; slot < links.size(); ++slot) {
+            if (free[slot]) continue;
+
+            std::construct_at(storage + slot, std::move(values[slot]));
+            std::destroy_at(values + slot);
+        }
+
+        if (values) std::allocator<T>{}.deallocate(values, value_capacity);
+        values = storage;
+        value_capacity = new_capacity;
+    }
+
+    void _release() noexcept {
+        if (!values) return;
+
+        std::vector<bool> free = _free_slots();
+
+        for (size_t slot = 0; slot < links.size(); ++slot) {
+            if (!free[slot]) std::destroy_at(values + slot);
+        }
+        std::allocator<T>{}.deallocate(values, value_capacity);
+        values = nullptr;
+        value_capacity = 0;
+    }
+
+    template <typename _T>
+    Index _allocate(_T&& value) {
+        if (free_head != npos) {
+            Index slot = free_head;
+
+            std::construct_at(values + slot, std::forward<_T>(value));
+            free_head = links[slot];
+            free_count--;
+
+            links[slot] = npos;
+            return slot;
+        }
+
+        if (links.size() == max_slots) _UNLIKELY {
+            throw std::length_error("ListArena: Index is too narrow for another node");
+        }
+        if (links.size() == value_capacity) {
+            _relocate(std::min(std::max<size_t>(value_capacity * 2, 8), max_slots));
+        }
+
+        std::construct_at(values + links.size(), std::forward<_T>(value));
+        links.push_back(npos);
+        return static_cast<Index>(links.size() - 1);
+    }
+
+    // the element is destroyed as its slot joins the free chain
+    void _deallocate(Index slot) noexcept {
+        std::destroy_at(values + slot);
+
+        links[slot] = free_head;
+        free_head = slot;
+        free_count++;
+    }
+
+    template <typename _T>
+    void _push_back(Handle& list, _T&& value) {
+        Index slot = _allocate(std::forward<_T>(value));
+
+        if (list.tail == npos) list.head = slot;
+        else links[list.tail] = slot;
+
+        list.tail = slot;
+        list.length++;
+    }
+
+public:
+    ListArena() = default;
+
+    explicit ListArena(size_t list_count, size_t node_capacity = 0) : lists(list_count) {
+        reserve(node_capacity);
+    }
+
+    // slots, handles and the free chain are copied as they are
+    ListArena(const ListArena& other)
+        : links(other.links), lists(other.lists), free_head(other.free_head), free_count(other.free_count)
+    {
+        values = std::allocator<T>{}.allocate(other.links.size());
+        value_capacity = other.links.size();
+
+        std::vector<bool> free = other._free_slots();
+
+        for (size_t slot = 0; slot < links.size(); ++slot) {
+            if (!free[slot]) std::construct_at(values + slot, other.values[slot]);
+        }
+    }
+
+    ListArena(ListArena&& other) noexcept {
+        swap(other);
+    }
+
+    ListArena& operator = (ListArena other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~ListArena() {
+        _release();
+    }
+
+    void swap(ListArena& other) noexcept {
+        std::swap(links, other.links);
+        std::swap(values, other.values);
+        std::swap(value_capacity, other.value_capacity);
+        std::swap(lists, other.lists);
+        std::swap(free_head, other.free_head);
+        std::swap(free_count, other.free_count);
+    }
+
+    void reserve(size_t nodes) {
+        if (nodes > max_slots) {
+            throw std::length_error("ListArena: Index is too narrow for the reserved nodes");
+        }
+        if (nodes > value_capacity) {
+            _relocate(nodes);
+        }
+    }
+
+    // returns the id of a new empty list
+    size_t create() {
+        lists.emplace_back();
+        return lists.size() - 1;
+    }
+
+    void resize(size_t list_count) {
+        for (size_t id = list_count; id < lists.size(); ++id) {
+            clear(id);
+        }
+        lists.resize(list_count);
+    }
+
+    // single pass over (list_id, value) pairs, appending each value to its list; ids past the end create lists
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    void build(Range first, Range last) {
+        if constexpr (std::is_convertible_v<
+            typename std::iterator_traits<Range>::iterator_category, std::forward_iterator_tag>)
+        {
+            reserve(links.size() + std::distance(first, last));
+        }
+
+        for (Range it = first; it != last; ++it) {
+            auto&& [id, value] = *it;
+
+            if (static_cast<size_t>(id) >= lists.size()) {
+                lists.resize(static_cast<size_t>(id) + 1);
+            }
+            _push_back(lists[id], value);
+        }
+    }
+
+    template <typename Iteratable>
+    void build(Iteratable&& pairs)
+    requires requires {
+        { std::begin(pairs) };
+        { std::end(pairs) };
+    }
+    {
+        build(std::begin(pairs), std::end(pairs));
+    }
+
+    template <typename _T>
+    requires std::is_convertible_v<_T, T>
+    Iterator insert_back(size_t id, _T&& value) {
+        _push_back(lists[id], std::forward<_T>(value));
+        return Iterator(this, lists[id].tail);
+    }
+
+    template <typename _T>
+    requires std::is_convertible_v<_T, T>
+    Iterator insert_front(size_t id, _T&& value) {
+        Index slot = _allocate(std::forward<_T>(value));
+        Handle& list = lists[id];
+
+        links[slot] = list.head;
+        list.head = slot;
+
+        if (list.tail == npos) list.tail = slot;
+
+        list.length++;
+        return Iterator(this, slot);
+    }
+
+    Iterator pop_front(size_t id) noexcept {
+        Handle& list = lists[id];
+        Index slot = list.head;
+
+        list.head = links[slot];
+        if (list.head == npos) list.tail = npos;
+
+        list.length--;
+        _deallocate(slot);
+
+        return begin(id);
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    void remove_if(size_t id, Predicate&& predicate) noexcept(
+        std::is_nothrow_invocable_r_v<bool, Predicate, T>)
+    {
+        Handle& list = lists[id];
+        Index prev = npos;
+
+        for (Index slot = list.head; slot != npos;) {
+            Index next = links[slot];
+
+            if (predicate(values[slot])) {
+                if (prev == npos) list.head = next;
+                else links[prev] = next;
+
+                if (slot == list.tail) list.tail = prev;
+
+                list.length--;
+                _deallocate(slot);
+            } else {
+                prev = slot;
+            }
+            slot = next;
+        }
+    }
+
+    void clear(size_t id) noexcept {
+        Handle& list = lists[id];
+
+        for (Index slot = list.head; slot != npos;) {
+            Index next = links[slot];
+            _deallocate(slot);
+            slot = next;
+        }
+        list = Handle{};
+    }
+
+    template <typename Predicate>
+    requires std::is_invocable_v<Predicate, T&>
+    void for_each(size_t id, Predicate&& predicate) noexcept(
+        std::is_nothrow_invocable_v<Predicate, T&>)
+    {
+        for (Index slot = lists[id].head; slot != npos; slot = links[slot]) {
+            predicate(values[slot]);
+        }
+    }
+
+    // lays every list out contiguously in id order and drops the free slots
+    void compact() {
+        size_t live = links.size() - free_count;
+
+        std::vector<Index> new_links;
+        new_links.reserve(live);
+
+        T* new_values = std::allocator<T>{}.allocate(live);
+
+        for (Handle& list : lists) {
+            if (list.head == npos) continue;
+
+            Index first = static_cast<Index>(new_links.size());
+
+            for (Index slot = list.head; slot != npos; slot = links[slot]) {
+                std::construct_at(new_values + new_links.size(), std::move(values[slot]));
+                new_links.push_back(static_cast<Index>(new_links.size() + 1));
+            }
+            new_links.back() = npos;
+
+            list.head = first;
+            list.tail = static_cast<Index>(new_links.size() - 1);
+        }
+
+        _release();
+
+        links = std::move(new_links);
+        values = new_values;
+        value_capacity = live;
+        free_head = npos;
+        free_count = 0;
+    }
+
+    // share of slots sitting in the free chain, a hint for when to compact()
+    double fragmentation() const noexcept {
+        return links.empty() ? 0.0 : static_cast<double>(free_count) / links.size();
+    }
+
+    Iterator begin(size_t id) noexcept {
+        return Iterator(this, lists[id].head);
+    }
+
+    Iterator end(size_t) noexcept {
+        return Iterator(this, npos);
+    }
+
+    const Handle& handle(size_t id) const noexcept {
+        return lists[id];
+    }
+
+    size_t size(size_t id) const noexcept {
+        return lists[id].length;
+    }
+
+    bool empty(size_t id) const noexcept {
+        return lists[id].length == 0;
+    }
+
+    size_t list_count() const noexcept {
+        return lists.size();
+    }
+
+    size_t node_count() const noexcept {
+        return links.size() - free_count;
+    }
+
+    T& front(size_t id) noexcept {
+        return values[lists[id].head];
+    }
+
+    T& back(size_t id) noexcept {
+        return values[lists[id].tail];
+    }
+};
+
+// List with structural sharing. snapshot() and copies are O(1): they share the nodes, which are reference counted.
+// A write copies only the shared nodes in front of the position it touches and reuses everything behind it,
+// so a snapshot costs memory proportional to the writes made after it. Unshared nodes are modified in place.
+// Snapshots only read their first length nodes, so appending links onto a tail shared with snapshots in place.
+// Snapshots may be read and released from other threads; the live list itself has a single owner.
+template <typename T, size_t Capacity = 24>
+class PersistentList {
+    struct Node {
+        T element;
+        Node* next;
+        std::atomic<size_t> refs = 1;
+
+        template <typename _T>
+        requires std::is_convertible_v<_T, T>
+        Node(_T&& element, Node* next) : element(std::forward<_T>(element)), next(next) {}
+    };
+
+    // outlives the live list as long as a snapshot still holds nodes
+    struct Pool {
+        std::mutex lock;
+        ChunkedNodeAllocator<Node, Capacity> allocator;
+    };
+
+    struct Path {
+        Node** link;
+        Node* prev;
+        size_t index;
+    };
+
+    std::shared_ptr<Pool> pool = std::make_shared<Pool>();
+
+    Node* head = nullptr;
+    Node* tail = nullptr;
+
+    size_t length = 0;
+    // nodes [0, unique_prefix) are known to be referenced by this list only
+    mutable size_t unique_prefix = 0;
+    // another list (not a snapshot) shares tail and may link onto it, appends must copy
+    mutable bool tail_shared = false;
+
+    template <typename _T>
+    static Node* _make(Pool& pool, _T&& element, Node* next) {
+        std::lock_guard guard(pool.lock);
+        return std::construct_at(pool.allocator.allocate(1), std::forward<_T>(element), next);
+    }
+
+    static Node* _acquire(Node* node) noexcept {
+        if (node) node->refs.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    static void _release(Pool& pool, Node* node) noexcept {
+        while (node && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Node* next = node->next;
+            {
+                std::lock_guard guard(pool.lock);
+                pool.allocator.deallocate(node, 1);
+            }
+            node = next;
+        }
+    }
+
+    // copies the shared nodes between path and target, returns the link that points at target
+    Path _own_from(Path path, const Node* target) {
+        while (*path.link != target) {
+            Node* node = *path.link;
+
+            if (path.index >= unique_prefix) {
+                if (node->refs.load(std::memory_order_acquire) != 1) {
+                    Node* copy = _make(*pool, node->element, _acquire(node->next));
+                    *path.link = copy;
+                    _release(*pool, node);
+
+                    if (!copy->next) tail = copy;
+                    node = copy;
+                }
+                unique_prefix = path.index + 1;
+            }
+
+            path.prev = node;
+            path.link = &node->next;
+            path.index++;
+        }
+        return path;
+    }
+
+    Path _own_until(const Node* target) {
+        return _own_from(Path{&head, nullptr, 0}, target);
+    }
+
+    template <typename _T>
+    void _insert(Path path, _T&& element) {
+        Node* node = _make(*pool, std::forward<_T>(element), *path.link);
+        *path.link = node;
+
+        if (!node->next) tail = node;
+
+        length++;
+
+        // an append behind shared nodes leaves them shared
+        if (path.index <= unique_prefix) unique_prefix++;
+    }
+
+    void _erase(Path path) noexcept {
+        Node* node = *path.link;
+
+        *path.link = _acquire(node->next);
+
+        if (node == tail) tail = path.prev;
+
+        if (path.index < unique_prefix) {
+            unique_prefix--;
+        }
+        _release(*pool, node);
+        length--;
+    }
+
+public:
+    class Iterator {
+    friend class PersistentList<T, Capacity>;
+        const Node* current;
+        // a snapshot's last node may have gained a next since, its iterators stop after length nodes
+        size_t remaining;
+
+        static const Node* _step(const Node* node, size_t& remaining) noexcept {
+            return --remaining ? node->next : nullptr;
+        }
+
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        Iterator() : current(nullptr), remaining(0) {}
+        explicit Iterator(const Node* current, size_t remaining = SIZE_MAX) : current(current), remaining(remaining) {}
+
+        Iterator& operator ++ () {
+            current = _step(current, remaining);
+            return *this;
+        }
+
+        Iterator operator ++ (int) {
+            Iterator temp = *this;
+            current = _step(current, remaining);
+            return temp;
+        }
+
+        Iterator operator + (int increment) const {
+            Iterator it = *this;
+
+            for (int i = 0; i < increment; ++i) {
+                ++it;
+            }
+            return it;
+        }
+
+        const T& operator * () const {
+            return current->element;
+        }
+
+        const T* operator -> () const {
+            return &current->element;
+        }
+
+        bool operator == (const Iterator& other) const {
+            return current == other.current;
+        }
+
+        bool operator != (const Iterator& other) const {
+            return current != other.current;
+        }
+    };
+
+    // immutable view, keeps its nodes alive and shares them with the list and other snapshots
+    class Snapshot {
+    friend class PersistentList<T, Capacity>;
+        std::shared_ptr<Pool> pool;
+        Node* head = nullptr;
+        size_t length = 0;
+
+        Snapshot(std::shared_ptr<Pool> pool, Node* head, size_t length)
+            : pool(std::move(pool)), head(_acquire(head)), length(length) {}
+
+    public:
+        Snapshot() = default;
+
+        Snapshot(const Snapshot& other) : pool(other.pool), head(_acquire(other.head)), length(other.length) {}
+
+        Snapshot& operator = (const Snapshot& other) {
+            if (this != &other) {
+                Snapshot temp(other);
+                *this = std::move(temp);
+            }
+            return *this;
+        }
+
+        Snapshot(Snapshot&& other) noexcept
+            : pool(std::move(other.pool)), head(std::exchange(other.head, nullptr)), length(std::exchange(other.length, 0)) {}
+
+        Snapshot& operator = (Snapshot&& other) noexcept {
+            if (this != &other) {
+                if (pool) _release(*pool, head);
+
+                pool = std::move(other.pool);
+                head = std::exchange(other.head, nullptr);
+                length = std::exchange(other.length, 0);
+            }
+            return *this;
+        }
+
+        ~Snapshot() noexcept {
+            if (pool) _release(*pool, head);
+        }
+
+        template <typename Predicate>
+        requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+        _NODISCARD Iterator find_if(Predicate&& predicate) const {
+            for (Iterator it = begin(); it != end(); ++it) {
+                if (predicate(*it)) return it;
+            }
+            return end();
+        }
+
+        _NODISCARD Iterator find(const T& to_find) const {
+            return find_if([&](const T& element) { return element == to_find; });
+        }
+
+        template <typename Predicate>
+        requires std::is_invocable_v<Predicate, const T&>
+        void for_each(Predicate&& predicate) const {
+            for (Iterator it = begin(); it != end(); ++it) {
+                predicate(*it);
+            }
+        }
+
+        size_t size() const noexcept {
+            return length;
+        }
+
+        bool empty() const noexcept {
+            return length == 0;
+        }
+
+        Iterator begin() const noexcept {
+            return length ? Iterator(head, length) : end();
+        }
+
+        Iterator end() const noexcept {
+            return Iterator(nullptr);
+        }
+
+        const T& front() const noexcept {
+            return head->element;
+        }
+    };
+
+    PersistentList() = default;
+
+    template <typename InputIterator>
+    PersistentList(InputIterator first, InputIterator last) {
+        for (InputIterator it = first; it != last; ++it) {
+            insert_back(*it);
+        }
+    }
+
+    PersistentList(std::initializer_list<T> ini_list) : PersistentList(ini_list.begin(), ini_list.end()) {}
+
+    // O(1), the two lists share nodes until one of them writes
+    PersistentList(const PersistentList& other)
+        : pool(other.pool), head(_acquire(other.head)), tail(other.tail), length(other.length), tail_shared(true)
+    {
+        other.unique_prefix = 0;
+        other.tail_shared = true;
+    }
+
+    PersistentList& operator = (const PersistentList& other) {
+        if (this != &other) {
+            PersistentList temp(other);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    PersistentList(PersistentList&& other) noexcept
+        : pool(other.pool), head(std::exchange(other.head, nullptr)), tail(std::exchange(other.tail, nullptr)),
+          length(std::exchange(other.length, 0)), unique_prefix(std::exchange(other.unique_prefix, 0)),
+          tail_shared(std::exchange(other.tail_shared, false)) {}
+
+    PersistentList& operator = (PersistentList&& other) noexcept {
+        if (this != &other) {
+            _release(*pool, head);
+
+            pool = other.pool;
+            head = std::exchange(other.head, nullptr);
+            tail = std::exchange(other.tail, nullptr);
+            length = std::exchange(other.length, 0);
+            unique_prefix = std::exchange(other.unique_prefix, 0);
+            tail_shared = std::exchange(other.tail_shared, false);
+        }
+        return *this;
+    }
+
+    ~PersistentList() noexcept {
+        _release(*pool, head);
+    }
+
+    _NODISCARD Snapshot snapshot() const {
+        unique_prefix = 0;
+        return Snapshot(pool, head, length);
+    }
+
+    T_Convertible Iterator insert_front(_T&& element) {
+        _insert(Path{&head, nullptr, 0}, std::forward<_T>(element));
+        return begin();
+    }
+
+    // O(1) unless another list shares the tail, then the shared nodes are copied once
+    T_Convertible Iterator insert_back(_T&& element) {
+        Path path = unique_prefix == length || !tail_shared
+            ? Path{tail ? &tail->next : &head, tail, length}
+            : _own_until(nullptr);
+
+        tail_shared = false;
+        _insert(path, std::forward<_T>(element));
+        return Iterator(tail);
+    }
+
+    // inserts before at
+    T_Convertible Iterator insert(Iterator at, _T&& element) {
+        Path path = _own_until(at.current);
+        _insert(path, std::forward<_T>(element));
+        return Iterator(*path.link);
+    }
+
+    T_Convertible Iterator set(Iterator at, _T&& element) {
+        Path path = _own_until(at.current);
+        Node* node = *path.link;
+
+        if (node->refs.load(std::memory_order_acquire) == 1) {
+            node->element = std::forward<_T>(element);
+        } else {
+            Node* copy = _make(*pool, std::forward<_T>(element), _acquire(node->next));
+            *path.link = copy;
+            _release(*pool, node);
+
+            if (!copy->next) tail = copy;
+            node = copy;
+        }
+        unique_prefix = std::max(unique_prefix, path.index + 1);
+        return Iterator(node);
+    }
+
+    Iterator erase(Iterator at) {
+        Path path = _own_until(at.current);
+        _erase(path);
+        return Iterator(*path.link);
+    }
+
+    Iterator pop_front() {
+        _erase(Path{&head, nullptr, 0});
+        return begin();
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    void remove_if(Predicate&& predicate) {
+        std::vector<const Node*> matches;
+
+        for (const Node* node = head; node != nullptr; node = node->next) {
+            if (predicate(node->element)) matches.push_back(node);
+        }
+
+        // one walk owns the prefix up to the last match, the rest of the list stays shared
+        Path path{&head, nullptr, 0};
+
+        for (const Node* match : matches) {
+            path = _own_from(path, match);
+            _erase(path);
+        }
+    }
+
+    void remove(const T& to_remove) {
+        remove_if([&](const T& element) { return element == to_remove; });
+    }
+
+    void clear() noexcept {
+        _release(*pool, head);
+        head = tail = nullptr;
+        length = 0;
+        unique_prefix = 0;
+        tail_shared = false;
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    _NODISCARD Iterator find_if(Predicate&& predicate) const {
+        for (Iterator it = begin(); it != end(); ++it) {
+            if (predicate(*it)) return it;
+        }
+        return end();
+    }
+
+    _NODISCARD Iterator find(const T& to_find) const {
+        return find_if([&](const T& element) { return element == to_find; });
+    }
+
+    template <typename Predicate>
+    requires std::is_invocable_v<Predicate, const T&>
+    void for_each(Predicate&& predicate) const {
+        for (Iterator it = begin(); it != end(); ++it) {
+            predicate(*it);
+        }
+    }
+
+    size_t size() const noexcept {
+        return length;
+    }
+
+    bool empty() const noexcept {
+        return length == 0;
+    }
+
+    Iterator begin() const noexcept {
+        return Iterator(head);
+    }
+
+    Iterator end() const noexcept {
+        return Iterator(nullptr);
+    }
+
+    const T& front() const noexcept {
+        return head->element;
+    }
+
+    const T& back() const noexcept {
+        return tail->element;
+    }
+};
+
+// ChunkedNodeAllocator with deferred reuse: retired nodes only go back to the pool once no reader can still see them
+template <typename T, size_t Capacity>
+class EpochNodeAllocator {
+    ChunkedNodeAllocator<T, Capacity> allocator;
+    std::vector<std::pair<T*, uint64_t>> retired;
+
+public:
+    using value_type = T;
+
+    T* allocate(size_t) {
+        return allocator.allocate(1);
+    }
+
+    void retire(T* ptr, uint64_t epoch) {
+        retired.emplace_back(ptr, epoch);
+    }
+
+    // hands back every node retired before safe_epoch
+    void reclaim(uint64_t safe_epoch) noexcept {
+        std::erase_if(retired, [&](const std::pair<T*, uint64_t>& node) {
+            if (node.second >= safe_epoch) return false;
+
+            allocator.deallocate(node.first, 1);
+            return true;
+        });
+    }
+
+    size_t pending() const noexcept {
+        return retired.size();
+    }
+};
+
+// One writer, many lock-free readers (RCU style).
+// The writer publishes every link change with a release store and never moves a node; unlinked nodes are
+// retired and reused only after all readers that could have seen them left their read section.
+// Readers take a slot once through reader(); after that a read section is a load, a store and a fence, no RMW.
+template <typename T, size_t Capacity = 24, size_t MaxReaders = 64>
+class ConcurrentList {
+    struct Node {
+        T element;
+        std::atomic<Node*> next = nullptr;
+
+        template <typename _T>
+        requires std::is_convertible_v<_T, T>
+        Node(_T&& element) : element(std::forward<_T>(element)) {}
+    };
+
+    struct alignas(64) Slot {
+        // epoch the reader entered in, 0 outside of a read section
+        std::atomic<uint64_t> epoch = 0;
+        std::atomic<bool> claimed = false;
+        // open sections, nested ones share the epoch published by the outermost; only the claiming thread touches it
+        size_t depth = 0;
+    };
+
+    static constexpr size_t reclaim_threshold = 64;
+
+    EpochNodeAllocator<Node, Capacity> allocator;
+
+    std::atomic<Node*> head = nullptr;
+    Node* tail = nullptr; // writer only
+
+    std::atomic<size_t> length = 0;
+
+    std::atomic<uint64_t> epoch = 1;
+    // reader() claims one on a const list
+    mutable std::array<Slot, MaxReaders> slots;
+
+    std::atomic<Node*>& _link(Node* prev) noexcept {
+        return prev ? prev->next : head;
+    }
+
+    void _enter(Slot& slot) const noexcept {
+        if (slot.depth++ != 0) return;
+
+        slot.epoch.store(epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        // pairs with the fence in reclaim(): either the writer sees this slot, or this reader sees the unlink
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    static void _exit(Slot& slot) noexcept {
+        if (--slot.depth != 0) return;
+
+        slot.epoch.store(0, std::memory_order_release);
+    }
+
+    void _publish(Node* prev, Node* node) noexcept {
+        _link(prev).store(node, std::memory_order_release);
+    }
+
+    void _retire(Node* node) {
+        allocator.retire(node, epoch.load(std::memory_order_relaxed));
+
+        if (allocator.pending() >= reclaim_threshold) {
+            reclaim();
+        }
+    }
+
+    void _unlink(Node* prev, Node* node) {
+        Node* next = node->next.load(std::memory_order_relaxed);
+
+        // node keeps pointing at next, a reader standing on it just walks on
+        _publish(prev, next);
+
+        if (node == tail) tail = prev;
+
+        length.store(length.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        _retire(node);
+    }
+
+public:
+    class Iterator {
+    friend class ConcurrentList<T, Capacity, MaxReaders>;
+        Node* prev;
+        Node* current;
+
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        Iterator() : prev(nullptr), current(nullptr) {}
+        explicit Iterator(Node* prev, Node* current) : prev(prev), current(current) {}
+
+        Iterator& operator ++ () {
+            prev = current;
+            current = current->next.load(std::memory_order_acquire);
+            return *this;
+        }
+
+        Iterator operator ++ (int) {
+            Iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        const T& operator * () const {
+            return current->element;
+        }
+
+        const T* operator -> () const {
+            return &current->element;
+        }
+
+        bool operator == (const Iterator& other) const {
+            return current == other.current;
+        }
+
+        bool operator != (const Iterator& other) const {
+            return current != other.current;
+        }
+    };
+
+    // a claimed reader slot, use from one thread at a time
+    class Reader {
+    friend class ConcurrentList<T, Capacity, MaxReaders>;
+        const ConcurrentList* list;
+        Slot* slot;
+
+        Reader(const ConcurrentList* list, Slot* slot) : list(list), slot(slot) {}
+
+    public:
+        // nodes reached through begin() stay valid until the section is destroyed.
+        // A section holds the slot rather than the Reader, so moving the Reader while it is open is fine;
+        // the Reader owning the slot must outlive it
+        class Section {
+        friend class Reader;
+            const ConcurrentList* list;
+            Slot* slot;
+
+            explicit Section(const ConcurrentList* list, Slot* slot) : list(list), slot(slot) {
+                list->_enter(*slot);
+            }
+
+        public:
+            Section(const Section&) = delete;
+            Section& operator = (const Section&) = delete;
+
+            ~Section() noexcept {
+                _exit(*slot);
+            }
+
+            Iterator begin() const noexcept {
+                return Iterator(nullptr, list->head.load(std::memory_order_acquire));
+            }
+
+            Iterator end() const noexcept {
+                return Iterator();
+            }
+        };
+
+        Reader(const Reader&) = delete;
+        Reader& operator = (const Reader&) = delete;
+
+        Reader(Reader&& other) noexcept : list(other.list), slot(std::exchange(other.slot, nullptr)) {}
+
+        Reader& operator = (Reader&& other) noexcept {
+            if (this != &other) {
+                if (slot) slot->claimed.store(false, std::memory_order_release);
+
+                list = other.list;
+                slot = std::exchange(other.slot, nullptr);
+            }
+            return *this;
+        }
+
+        ~Reader() noexcept {
+            if (slot) slot->claimed.store(false, std::memory_order_release);
+        }
+
+        _NODISCARD Section read() const noexcept {
+            return Section(list, slot);
+        }
+
+        template <typename Predicate>
+        requires std::is_invocable_v<Predicate, const T&>
+        void for_each(Predicate&& predicate) const {
+            Section section = read();
+
+            for (const T& element : section) {
+                predicate(element);
+            }
+        }
+
+        template <typename Predicate>
+        requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+        _NODISCARD std::optional<T> find_if(Predicate&& predicate) const {
+            Section section = read();
+
+            for (const T& element : section) {
+                if (predicate(element)) return element;
+            }
+            return std::nullopt;
+        }
+
+        _NODISCARD bool contains(const T& value) const {
+            return find_if([&](const T& element) { return element == value; }).has_value();
+        }
+    };
+
+    ConcurrentList() = default;
+
+    ConcurrentList(const ConcurrentList&) = delete;
+    ConcurrentList& operator = (const ConcurrentList&) = delete;
+
+    // claims one of the MaxReaders slots, the only RMW on the read side
+    _NODISCARD Reader reader() const {
+        for (Slot& slot : slots) {
+            bool expected = false;
+
+            if (slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return Reader(this, &slot);
+            }
+        }
+        throw std::length_error("ConcurrentList: all reader slots are taken");
+    }
+
+    // writer side, one thread at a time
+
+    T_Convertible Iterator insert_front(_T&& element) {
+        Node* node = std::construct_at(allocator.allocate(1), std::forward<_T>(element));
+        node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        _publish(nullptr, node);
+
+        if (!tail) tail = node;
+
+        length.store(length.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return Iterator(nullptr, node);
+    }
+
+    T_Convertible Iterator insert_back(_T&& element) {
+        return insert(end(), std::forward<_T>(element));
+    }
+
+    // inserts before at
+    T_Convertible Iterator insert(Iterator at, _T&& element) {
+        if (at.current == nullptr) at.prev = tail;
+
+        Node* node = std::construct_at(allocator.allocate(1), std::forward<_T>(element));
+        node->next.store(at.current, std::memory_order_relaxed);
+
+        _publish(at.prev, node);
+
+        if (!at.current) tail = node;
+
+        length.store(length.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return Iterator(at.prev, node);
+    }
+
+    Iterator erase(Iterator at) {
+        Node* next = at.current->next.load(std::memory_order_relaxed);
+        _unlink(at.prev, at.current);
+        return Iterator(at.prev, next);
+    }
+
+    Iterator pop_front() {
+        return erase(begin());
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    void remove_if(Predicate&& predicate) {
+        for (Iterator it = begin(); it != end();) {
+            if (predicate(*it)) {
+                it = erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void remove(const T& to_remove) {
+        remove_if([&](const T& element) { return element == to_remove; });
+    }
+
+    void clear() {
+        Node* current = head.load(std::memory_order_relaxed);
+
+        _publish(nullptr, nullptr);
+        tail = nullptr;
+        length.store(0, std::memory_order_relaxed);
+
+        while (current != nullptr) {
+            Node* next = current->next.load(std::memory_order_relaxed);
+            _retire(current);
+            current = next;
+        }
+    }
+
+    // advances the epoch and returns retired nodes no active reader can reach to the pool
+    void reclaim() noexcept {
+        uint64_t current = epoch.load(std::memory_order_relaxed);
+        epoch.store(current + 1, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        uint64_t safe = current + 1;
+
+        for (const Slot& slot : slots) {
+            uint64_t entered = slot.epoch.load(std::memory_order_acquire);
+
+            if (entered != 0 && entered < safe) safe = entered;
+        }
+        allocator.reclaim(safe);
+    }
+
+    // the writer can walk without a read section, nothing is freed under it
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    _NODISCARD Iterator find_if(Predicate&& predicate) const {
+        for (Iterator it = begin(); it != end(); ++it) {
+            if (predicate(*it)) return it;
+        }
+        return end();
+    }
+
+    _NODISCARD Iterator find(const T& to_find) const {
+        return find_if([&](const T& element) { return element == to_find; });
+    }
+
+    size_t size() const noexcept {
+        return length.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    Iterator begin() const noexcept {
+        return Iterator(nullptr, head.load(std::memory_order_acquire));
+    }
+
+    Iterator end() const noexcept {
+        return Iterator(tail, nullptr);
+    }
+};
+
+template <typename K, typename V, size_t Capacity>
+class LruCache {
+    struct Node {
+        K key;
+        V value;
+        size_t hash;
+        Node* prev = nullptr;
+        Node* next = nullptr;
+
+        template <typename _K, typename _V>
+        constexpr Node(_K&& key, _V&& value, size_t hash)
+            : key(std::forward<_K>(key)), value(std::forward<_V>(value)), hash(hash) {}
+    };
+
+    static constexpr size_t _table_size() noexcept {
+        size_t size = 1;
+        while (size < Capacity * 2) size <<= 1;
+        return size;
+    }
+
+    static constexpr size_t table_size = _table_size();
+    static constexpr size_t mask = table_size - 1;
+
+    // the pool never grows, evicted nodes are destroyed, handed back to it and reused by the next put
+    NodeAllocator<Node, Capacity> allocator;
+    // open addressing, linear probing, backward shift on erase -> no tombstones, no rehash
+    std::array<Node*, table_size> table{};
+
+    Node* head = nullptr; // most recently used
+    Node* tail = nullptr; // least recently used
+
+    size_t length = 0;
+
+    std::function<void(const K&, V&)> on_evict;
+
+    size_t _find_slot(const K& key, size_t hash) const noexcept {
+        size_t slot = hash & mask;
+
+        while (table[slot] != nullptr) {
+            if (table[slot]->hash == hash && table[slot]->key == key) {
+                return slot;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void _erase_slot(size_t slot) noexcept {
+        size_t next = slot;
+
+        while (true) {
+            next = (next + 1) & mask;
+
+            if (table[next] == nullptr) break;
+
+            size_t home = table[next]->hash & mask;
+
+            bool movable = slot <= next
+                ? (home <= slot || home > next)
+                : (home <= slot && home > next);
+
+            if (movable) {
+                table[slot] = table[next];
+                slot = next;
+            }
+        }
+        table[slot] = nullptr;
+    }
+
+    void _unlink(Node* node) noexcept {
+        if (node->prev) node->prev->next = node->next;
+        else head = node->next;
+
+        if (node->next) node->next->prev = node->prev;
+        else tail = node->prev;
+
+        node->prev = node->next = nullptr;
+    }
+
+    void _link_front(Node* node) noexcept {
+        node->next = head;
+
+        if (head) head->prev = node;
+        else tail = node;
+
+        head = node;
+    }
+
+    void _move_front(Node* node) noexcept {
+        if (node == head) return;
+
+        _unlink(node);
+        _link_front(node);
+    }
+
+    void _remove(size_t slot) noexcept {
+        Node* node = table[slot];
+
+        _erase_slot(slot);
+        _unlink(node);
+        allocator.deallocate(node, 1);
+        length--;
+    }
+
+public:
+    LruCache() : allocator(Capacity) {
+        static_assert(Capacity > 0, "LruCache needs room for at least one entry");
+    }
+
+    template <typename Evict>
+    requires std::is_invocable_v<Evict, const K&, V&>
+    explicit LruCache(Evict&& on_evict) : allocator(Capacity), on_evict(std::forward<Evict>(on_evict)) {}
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator = (const LruCache&) = delete;
+
+    template <typename _V>
+    requires std::is_convertible_v<_V, V>
+    V& put(const K& key, _V&& value) {
+        size_t hash = std::hash<K>{}(key);
+        size_t slot = _find_slot(key, hash);
+
+        if (table[slot] != nullptr) {
+            table[slot]->value = std::forward<_V>(value);
+            _move_front(table[slot]);
+            return head->value;
+        }
+
+        if (length == Capacity) {
+            evict();
+            slot = _find_slot(key, hash);
+        }
+
+        Node* node = std::construct_at(allocator.allocate(1), key, std::forward<_V>(value), hash);
+        table[slot] = node;
+        _link_front(node);
+        length++;
+
+        return node->value;
+    }
+
+    // touches the entry on hit
+    _NODISCARD V* get(const K& key) noexcept {
+        size_t slot = _find_slot(key, std::hash<K>{}(key));
+
+        if (table[slot] == nullptr) return nullptr;
+
+        _move_front(table[slot]);
+        return &head->value;
+    }
+
+    _NODISCARD const V* peek(const K& key) const noexcept {
+        Node* node = table[_find_slot(key, std::hash<K>{}(key))];
+        return node ? &node->value : nullptr;
+    }
+
+    bool touch(const K& key) noexcept {
+        return get(key) != nullptr;
+    }
+
+    _NODISCARD bool contains(const K& key) const noexcept {
+        return peek(key) != nullptr;
+    }
+
+    bool erase(const K& key) noexcept {
+        size_t slot = _find_slot(key, std::hash<K>{}(key));
+
+        if (table[slot] == nullptr) return false;
+
+        _remove(slot);
+        return true;
+    }
+
+    // drops the least recently used entry, calling the eviction callback first
+    bool evict() {
+        if (!tail) return false;
+
+        if (on_evict) {
+            on_evict(tail->key, tail->value);
+        }
+        _remove(_find_slot(tail->key, tail->hash));
+        return true;
+    }
+
+    void clear() noexcept {
+        while (head) {
+            _remove(_find_slot(head->key, head->hash));
+        }
+    }
+
+    // most recently used first
+    template <typename Predicate>
+    requires std::is_invocable_v<Predicate, const K&, V&>
+    void for_each(Predicate&& predicate) {
+        for (Node* node = head; node != nullptr; node = node->next) {
+            predicate(node->key, node->value);
+        }
+    }
+
+    _NODISCARD const K* lru_key() const noexcept {
+        return tail ? &tail->key : nullptr;
+    }
+
+    constexpr size_t size() const noexcept {
+        return length;
+    }
+
+    constexpr bool empty() const noexcept {
+        return length == 0;
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return Capacity;
+    }
+};
+
+enum class TraceOp : uint8_t {
+    InsertFront,
+    InsertBack,
+    Insert,
+    InsertRange,
+    PopFront,
+    PopBack,
+    Erase,
+    EraseRange,
+    Assign,
+    Clear,
+    Find,
+    FindIf,
+    RemoveIf,
+    ForEach,
+    Sort,
+    Unique,
+    // appended so traces written before them still read
+    Reserve,
+    UniqueAll,
+    Remove,
+    Filter,
+    Sublist,
+    Merge,
+    Reverse,
+    Rotate,
+    StablePartition,
+    Partition,
+    SplitAt,
+    PartitionInto,
+    RadixSort,
+    Count
+};
+
+// position: list index the call worked at (found index for Find / FindIf, first match for Remove,
+// size when nothing matched, middle for Rotate, split point for SplitAt / Sublist)
+// size: list size before the call
+// count: elements inserted / erased / assigned / removed / merged / reserved / kept by Filter,
+// sublist length, size of the first group for StablePartition / Partition, moved out for PartitionInto
+struct TraceRecord {
+    TraceOp op;
+    uint64_t position = 0;
+    uint64_t size = 0;
+    uint64_t count = 0;
+};
+
+constexpr std::string_view trace_op_name(TraceOp op) noexcept {
+    constexpr std::array<std::string_view, static_cast<size_t>(TraceOp::Count)> names = {
+        "insert_front", "insert_back", "insert", "insert_range", "pop_front", "pop_back", "erase",
+        "erase_range", "assign", "clear", "find", "find_if", "remove_if", "for_each", "sort", "unique",
+        "reserve", "unique_all", "remove", "filter", "sublist", "merge", "reverse", "rotate",
+        "stable_partition", "partition", "split_at", "partition_into", "radix_sort"
+    };
+    return names[static_cast<size_t>(op)];
+}
+
+// "LTRC" + version, then per record: op byte and three LEB128 varints, usually 4-8 bytes a call.
+// Version 2 varints hold 64 bits, version 1 ones 32; both encode a small value the same way, so both read.
+class TraceWriter {
+    static constexpr char magic[5] = {'L', 'T', 'R', 'C', 2};
+
+    std::ostream& out;
+
+    void _varint(uint64_t value) {
+        while (value >= 0x80) {
+            out.put(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+public:
+    explicit TraceWriter(std::ostream& out) : out(out) {
+        out.write(magic, sizeof(magic));
+    }
+
+    void write(const TraceRecord& record) {
+        out.put(static_cast<char>(record.op));
+        _varint(record.position);
+        _varint(record.size);
+        _varint(record.count);
+    }
+
+    static std::vector<TraceRecord> read(std::istream& in) {
+        std::vector<TraceRecord> records;
+
+        char header[sizeof(magic)];
+        if (!in.read(header, sizeof(header)) || !std::equal(header, header + 4, magic) || header[4] < 1 || header[4] > magic[4]) {
+            return records;
+        }
+        const int value_bits = header[4] == 1 ? 32 : 64;
+
+        auto varint = [&](uint64_t& value) {
+            value = 0;
+
+            for (int shift = 0; shift < value_bits; shift += 7) {
+                int byte = in.get();
+                if (byte == EOF) return false;
+
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        };
+
+        for (int op = in.get(); op != EOF && op < static_cast<int>(TraceOp::Count); op = in.get()) {
+            TraceRecord record{static_cast<TraceOp>(op)};
+
+            if (!varint(record.position) || !varint(record.size) || !varint(record.count)) break;
+
+            records.push_back(record);
+        }
+        return records;
+    }
+};
+
+// opt-in: a List that logs every mutating or query call to a TraceWriter. Calls that are not traced
+// (comparisons, operator +, swap, to_array) are deleted instead of inherited, so nothing reaches Base
+// unrecorded and a trace always replays the workload that produced it
+template <typename T, size_t Capacity = 24, NodeLayout Layout = NodeLayout::Inline>
+class RecordingList : public List<T, Capacity, Layout> {
+    using Base = List<T, Capacity, Layout>;
+    using BaseIterator = decltype(std::declval<Base&>().begin());
+
+public:
+    // Base's iterator plus its index in the list. ++ and + keep the index up to date,
+    // so a call records the position it works at without walking there
+    class Iterator : public BaseIterator {
+    friend class RecordingList;
+        size_t index;
+
+        Iterator(BaseIterator it, size_t index) : BaseIterator(it), index(index) {}
+
+    public:
+        Iterator& operator ++ () {
+            ++static_cast<BaseIterator&>(*this);
+            index++;
+            return *this;
+        }
+
+        Iterator operator ++ (int) {
+            Iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        Iterator operator + (int increment) const {
+            return Iterator(BaseIterator::operator + (increment), index + increment);
+        }
+
+        size_t position() const noexcept {
+            return index;
+        }
+    };
+
+private:
+    TraceWriter* trace;
+
+    void _record(TraceOp op, size_t position, size_t size, size_t count = 0) {
+        trace->write(TraceRecord{op, position, size, count});
+    }
+
+    // the index of what was found is counted by the search itself
+    template <typename Predicate>
+    Iterator _find(TraceOp op, Iterator from, Iterator to, Predicate&& predicate) {
+        size_t index = from.index;
+        BaseIterator it = Base::find_if(from, to, [&](const T& value) {
+            if (predicate(value)) return true;
+            index++;
+            return false;
+        });
+        _record(op, index, Base::size());
+        return Iterator(it, index);
+    }
+
+public:
+    explicit RecordingList(TraceWriter& trace, size_t capacity = Capacity) : Base(capacity), trace(&trace) {}
+
+    RecordingList(TraceWriter& trace, std::pmr::memory_resource* resource, size_t capacity = Capacity)
+        : Base(resource, capacity), trace(&trace) {}
+
+    Iterator begin() const {
+        return Iterator(Base::begin(), 0);
+    }
+
+    Iterator end() const {
+        return Iterator(Base::end(), Base::size());
+    }
+
+    void reserve(size_t elements) {
+        _record(TraceOp::Reserve, 0, Base::size(), elements);
+        Base::reserve(elements);
+    }
+
+    // like List, the returned iterator is the one past the inserted element
+    T_Convertible Iterator insert_front(_T&& element) {
+        _record(TraceOp::InsertFront, 0, Base::size());
+        return Iterator(Base::insert_front(std::forward<_T>(element)), 1);
+    }
+
+    T_Convertible Iterator insert_back(_T&& element) {
+        _record(TraceOp::InsertBack, Base::size(), Base::size());
+        return Iterator(Base::insert_back(std::forward<_T>(element)), Base::size());
+    }
+
+    T_Convertible Iterator insert(Iterator at, _T&& element) {
+        _record(TraceOp::Insert, at.index, Base::size());
+        return Iterator(Base::insert(at, std::forward<_T>(element)), at.index + 1);
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    Iterator insert_range(Iterator from, Range first, Range last) {
+        size_t n = std::distance(first, last);
+        _record(TraceOp::InsertRange, from.index, Base::size(), n);
+        return Iterator(Base::insert_range(from, first, last), from.index + n);
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    Iterator insert_range(Range first, Range last) {
+        return insert_range(begin(), first, last);
+    }
+
+    template <typename Iteratable>
+    Iterator insert_range(Iterator from, Iteratable&& container)
+    requires requires {
+        { std::begin(container) };
+        { std::end(container) };
+    }
+    {
+        size_t n = std::distance(std::begin(container), std::end(container));
+        _record(TraceOp::InsertRange, from.index, Base::size(), n);
+        return Iterator(Base::insert_range(from, std::forward<Iteratable>(container)), from.index + n);
+    }
+
+    template <typename... Ts>
+    requires std::conjunction_v<std::is_convertible<T, Ts>...>
+    Iterator insert_range(Iterator from, Ts&&... elements) {
+        _record(TraceOp::InsertRange, from.index, Base::size(), sizeof...(elements));
+        return Iterator(Base::insert_range(from, std::forward<Ts>(elements)...), from.index + sizeof...(elements));
+    }
+
+    template <typename Generator>
+    requires std::is_convertible_v<std::invoke_result_t<Generator>, T>
+    Iterator insert_range(Iterator from, size_t n, Generator&& gen) {
+        _record(TraceOp::InsertRange, from.index, Base::size(), n);
+        return Iterator(Base::insert_range(from, n, std::forward<Generator>(gen)), from.index + n);
+    }
+
+    Iterator pop_front() {
+        _record(TraceOp::PopFront, 0, Base::size());
+        return Iterator(Base::pop_front(), 0);
+    }
+
+    Iterator pop_back() {
+        _record(TraceOp::PopBack, Base::size() ? Base::size() - 1 : 0, Base::size());
+        BaseIterator last = Base::pop_back();
+        return Iterator(last, Base::size() ? Base::size() - 1 : 0);
+    }
+
+    Iterator erase(Iterator at) {
+        _record(TraceOp::Erase, at.index, Base::size());
+        return Iterator(Base::erase(at), at.index);
+    }
+
+    Iterator erase_range(Iterator from, Iterator to) {
+        _record(TraceOp::EraseRange, from.index, Base::size(), to.index - from.index);
+        return Iterator(Base::erase_range(from, to), from.index);
+    }
+
+    Iterator erase_range(Iterator from) {
+        return erase_range(from, end());
+    }
+
+    T_Convertible void assign(size_t n, _T&& val) {
+        _record(TraceOp::Assign, 0, Base::size(), n);
+        Base::assign(n, std::forward<_T>(val));
+    }
+
+    template <typename Range>
+    requires std::is_convertible_v<
+        typename std::iterator_traits<Range>::iterator_category, std::input_iterator_tag
+    >
+    void assign(Range first, Range last) {
+        _record(TraceOp::Assign, 0, Base::size(), std::distance(first, last));
+        Base::assign(first, last);
+    }
+
+    T_Convertible void assign(std::initializer_list<_T> ini_list) {
+        assign(ini_list.begin(), ini_list.end());
+    }
+
+    template <typename Generator>
+    requires std::is_convertible_v<std::invoke_result_t<Generator>, T>
+    void assign(size_t n, Generator&& gen) {
+        _record(TraceOp::Assign, 0, Base::size(), n);
+        Base::assign(n, std::forward<Generator>(gen));
+    }
+
+    void clear() {
+        _record(TraceOp::Clear, 0, Base::size());
+        Base::clear();
+    }
+
+    void unique() {
+        size_t before = Base::size();
+        Base::unique();
+        _record(TraceOp::Unique, 0, before, before - Base::size());
+    }
+
+    void unique_all() {
+        size_t before = Base::size();
+        Base::unique_all();
+        _record(TraceOp::UniqueAll, 0, before, before - Base::size());
+    }
+
+    _NODISCARD Iterator find(const T& to_find, Iterator from, Iterator to) {
+        return _find(TraceOp::Find, from, to, [&](const T& value) { return value == to_find; });
+    }
+
+    _NODISCARD Iterator find(const T& to_find) {
+        return find(to_find, begin(), end());
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    _NODISCARD Iterator find_if(Iterator from, Iterator to, Predicate&& predicate) {
+        return _find(TraceOp::FindIf, from, to, predicate);
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    _NODISCARD Iterator find_if(Predicate&& predicate) {
+        return find_if(begin(), end(), std::forward<Predicate>(predicate));
+    }
+
+    void remove(const T& to_remove, Iterator from, Iterator to) {
+        size_t before = Base::size();
+        // the first match is erased, so the index after it is never stale
+        size_t first = before;
+        bool found = false;
+        Base::remove_if(from, to, [&, index = from.index](const T& value) mutable {
+            bool match = value == to_remove;
+            if (match && !found) first = index, found = true;
+            index++;
+            return match;
+        });
+        _record(TraceOp::Remove, first, before, before - Base::size());
+    }
+
+    void remove(const T& to_remove) {
+        remove(to_remove, begin(), end());
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    void remove_if(Iterator from, Iterator to, Predicate&& predicate) {
+        size_t before = Base::size();
+        Base::remove_if(from, to, std::forward<Predicate>(predicate));
+        _record(TraceOp::RemoveIf, 0, before, before - Base::size());
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    void remove_if(Predicate&& predicate) {
+        remove_if(begin(), end(), std::forward<Predicate>(predicate));
+    }
+
+    template <typename Predicate>
+    requires std::is_invocable_r_v<void, Predicate, T>
+    void for_each(Predicate&& predicate) {
+        _record(TraceOp::ForEach, 0, Base::size());
+        Base::for_each(std::forward<Predicate>(predicate));
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    _NODISCARD Base filter(Predicate&& predicate) {
+        Base kept = Base::filter(std::forward<Predicate>(predicate));
+        _record(TraceOp::Filter, 0, Base::size(), kept.size());
+        return kept;
+    }
+
+    _NODISCARD Base sublist(Iterator from, Iterator to) {
+        _record(TraceOp::Sublist, from.index, Base::size(), to.index - from.index);
+        return Base::sublist(from, to);
+    }
+
+    void merge(Base& other) {
+        _record(TraceOp::Merge, Base::size(), Base::size(), other.size());
+        Base::merge(other);
+    }
+
+    void reverse() {
+        _record(TraceOp::Reverse, 0, Base::size());
+        Base::reverse();
+    }
+
+    void rotate(Iterator middle) {
+        _record(TraceOp::Rotate, middle.index, Base::size());
+        Base::rotate(middle);
+    }
+
+    // the first group's size is counted while partitioning, predicate runs once per element
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    Iterator stable_partition(Predicate&& predicate) {
+        size_t selected = 0;
+        BaseIterator second = Base::stable_partition([&](const auto& value) {
+            bool result = predicate(value);
+            selected += result;
+            return result;
+        });
+        _record(TraceOp::StablePartition, 0, Base::size(), selected);
+        return Iterator(second, selected);
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    Iterator partition(Predicate&& predicate) {
+        size_t selected = 0;
+        BaseIterator second = Base::partition([&](const auto& value) {
+            bool result = predicate(value);
+            selected += result;
+            return result;
+        });
+        _record(TraceOp::Partition, 0, Base::size(), selected);
+        return Iterator(second, selected);
+    }
+
+    _NODISCARD Base split_at(Iterator at) {
+        _record(TraceOp::SplitAt, at.index, Base::size(), Base::size() - at.index);
+        return Base::split_at(at);
+    }
+
+    template <typename Predicate>
+    requires std::is_convertible_v<std::invoke_result_t<Predicate, T>, bool>
+    size_t partition_into(Base& out, Predicate&& predicate) {
+        size_t before = Base::size();
+        size_t moved = Base::partition_into(out, std::forward<Predicate>(predicate));
+        _record(TraceOp::PartitionInto, 0, before, moved);
+        return moved;
+    }
+
+    template <typename KeyExtractor = std::identity>
+    void radix_sort(KeyExtractor&& key = KeyExtractor{}) {
+        _record(TraceOp::RadixSort, 0, Base::size());
+        Base::radix_sort(std::forward<KeyExtractor>(key));
+    }
+
+    template <typename SortMethod = std::less<T>>
+    void sort(SortMethod&& sort_method = SortMethod{}) {
+        _record(TraceOp::Sort, 0, Base::size());
+        Base::sort(std::forward<SortMethod>(sort_method));
+    }
+
+    bool operator == (const Base&) const = delete;
+    bool operator != (const Base&) const = delete;
+    bool operator > (const Base&) const = delete;
+    bool operator < (const Base&) const = delete;
+    Base operator + (const Base&) = delete;
+    RecordingList& operator += (const Base&) = delete;
+
+    template <typename... Args>
+    void swap(Args&&...) = delete;
+
+    template <size_t N>
+    std::array<T, N> to_array() const = delete;
+};
+
+// Replays a trace against one list configuration. Elements are ints from a counter; positions are clamped,
+// so a configuration that drifts from the recorded sizes keeps running instead of failing.
+// prepare() does the per record setup (input values, the value a find will hit) outside the timed apply().
+template <typename ListType>
+class TraceReplay {
+    static constexpr bool is_std_list = std::is_same_v<ListType, std::list<int>>;
+
+    ListType list;
+    int next_value = 0;
+
+    std::vector<int> values;
+    // counter values are never negative, so -1 is never found
+    int target = -1;
+
+    auto _at(size_t position) {
+        position = std::min(position, list.size());
+
+        if constexpr (is_std_list) {
+            return std::next(list.begin(), position);
+        } else {
+            return position == list.size() ? list.end() : list.begin() + static_cast<int>(position);
+        }
+    }
+
+    void _push_front() {
+        if constexpr (is_std_list) list.push_front(next_value++);
+        else list.insert_front(next_value++);
+    }
+
+    void _push_back() {
+        if constexpr (is_std_list) list.push_back(next_value++);
+        else list.insert_back(next_value++);
+    }
+
+    void _insert(size_t position) {
+        if constexpr (is_std_list) list.insert(_at(position), next_value++);
+        else list.insert(_at(position), next_value++);
+    }
+
+    // selects count of size elements, spread evenly
+    static auto _every(size_t count, size_t size) {
+        size_t stride = count ? std::max<size_t>(1, size / count) : 0;
+
+        return [stride, count, index = size_t{0}, selected = size_t{0}](const int&) mutable {
+            bool select = stride && selected < count && index++ % stride == 0;
+            selected += select;
+            return select;
+        };
+    }
+
+    // std::list counterpart of List's partition, selected elements stay in front, rest is spliced off
+    template <typename Predicate>
+    static void _relink_partition(std::list<int>& list, std::list<int>& rest, Predicate predicate) {
+        for (auto it = list.begin(); it != list.end();) {
+            auto next = std::next(it);
+            if (!predicate(*it)) rest.splice(rest.end(), list, it);
+            it = next;
+        }
+    }
+
+    template <typename Value>
+    static void _sink(const Value& value) {
+        volatile auto sink = value;
+        (void)sink;
+    }
+
+public:
+    template <typename... Args>
+    explicit TraceReplay(Args&&... args) : list(std::forward<Args>(args)...) {}
+
+    void prepare(const TraceRecord& record) {
+        switch (record.op) {
+        case TraceOp::InsertRange:
+        case TraceOp::Assign:
+        case TraceOp::Merge:
+            values.resize(record.count);
+            std::iota(values.begin(), values.end(), next_value);
+            next_value += record.count;
+            break;
+        case TraceOp::Find:
+        case TraceOp::FindIf:
+        case TraceOp::Remove:
+            target = record.position < list.size() ? *_at(record.position) : -1;
+            break;
+        default:
+            break;
+        }
+    }
+
+    void apply(const TraceRecord& record) {
+        size_t size = list.size();
+
+        switch (record.op) {
+        case TraceOp::InsertFront:
+            _push_front();
+            break;
+        case TraceOp::InsertBack:
+            _push_back();
+            break;
+        case TraceOp::Insert:
+            _insert(record.position);
+            break;
+        case TraceOp::InsertRange:
+            if (values.empty()) break;
+
+            if constexpr (is_std_list) list.insert(_at(record.position), values.begin(), values.end());
+            else list.insert_range(_at(record.position), values.begin(), values.end());
+            break;
+        case TraceOp::PopFront:
+            if (size) list.pop_front();
+            break;
+        case TraceOp::PopBack:
+            if (size) list.pop_back();
+            break;
+        case TraceOp::Erase:
+            if (record.position < size) list.erase(_at(record.position));
+            break;
+        case TraceOp::EraseRange: {
+            size_t first = std::min<size_t>(record.position, size);
+            size_t last = std::min<size_t>(first + record.count, size);
+
+            if (first == last) break;
+
+            if constexpr (is_std_list) list.erase(_at(first), _at(last));
+            else list.erase_range(_at(first), _at(last));
+            break;
+        }
+        case TraceOp::Assign:
+            if (values.empty()) list.clear();
+            else list.assign(values.begin(), values.end());
+            break;
+        case TraceOp::Clear:
+            list.clear();
+            break;
+        case TraceOp::Find:
+            if constexpr (is_std_list) _sink(std::find(list.begin(), list.end(), target) != list.end());
+            else _sink(list.find(target) != list.end());
+            break;
+        case TraceOp::FindIf: {
+            auto matches = [&](const int& value) { return value == target; };
+
+            if constexpr (is_std_list) _sink(std::find_if(list.begin(), list.end(), matches) != list.end());
+            else _sink(list.find_if(matches) != list.end());
+            break;
+        }
+        case TraceOp::Remove:
+            list.remove(target);
+            break;
+        case TraceOp::RemoveIf:
+            list.remove_if(_every(record.count, size));
+            break;
+        case TraceOp::ForEach: {
+            long long sum = 0;
+            auto add = [&](const int& value) { sum += value; };
+
+            if constexpr (is_std_list) std::for_each(list.begin(), list.end(), add);
+            else list.for_each(add);
+            _sink(sum);
+            break;
+        }
+        case TraceOp::Sort:
+            list.sort();
+            // List::sort drops elements equal to an earlier one, std::list::sort keeps them
+            if constexpr (is_std_list) list.unique();
+            break;
+        case TraceOp::Unique:
+            list.unique();
+            break;
+        case TraceOp::Reserve:
+            if constexpr (!is_std_list) list.reserve(record.count);
+            break;
+        case TraceOp::UniqueAll:
+            if constexpr (is_std_list) {
+                std::set<int> visited;
+                list.remove_if([&](const int& value) { return !visited.insert(value).second; });
+            } else {
+                list.unique_all();
+            }
+            break;
+        case TraceOp::Filter:
+            if constexpr (is_std_list) {
+                std::list<int> kept;
+                std::copy_if(list.begin(), list.end(), std::back_inserter(kept), _every(record.count, size));
+                _sink(kept.size());
+            } else {
+                _sink(list.filter(_every(record.count, size)).size());
+            }
+            break;
+        case TraceOp::Sublist: {
+            size_t first = std::min<size_t>(record.position, size);
+            size_t last = std::min<size_t>(first + record.count, size);
+
+            if (first == last) break;
+
+            if constexpr (is_std_list) _sink(std::list<int>(_at(first), _at(last)).size());
+            else _sink(list.sublist(_at(first), _at(last)).size());
+            break;
+        }
+        case TraceOp::Merge: {
+            ListType other;
+
+            for (int value : values) {
+                if constexpr (is_std_list) other.push_back(value);
+                else other.insert_back(value);
+            }
+
+            if constexpr (is_std_list) list.splice(list.end(), other);
+            else list.merge(other);
+            break;
+        }
+        case TraceOp::Reverse:
+            list.reverse();
+            break;
+        case TraceOp::Rotate:
+            if (record.position == 0 || record.position >= size) break;
+
+            if constexpr (is_std_list) list.splice(list.end(), list, list.begin(), _at(record.position));
+            else list.rotate(_at(record.position));
+            break;
+        case TraceOp::StablePartition:
+        case TraceOp::Partition:
+            if constexpr (is_std_list) {
+                std::list<int> rest;
+                _relink_partition(list, rest, _every(record.count, size));
+                list.splice(list.end(), rest);
+            } else if (record.op == TraceOp::Partition) {
+                list.partition(_every(record.count, size));
+            } else {
+                list.stable_partition(_every(record.count, size));
+            }
+            break;
+        case TraceOp::SplitAt:
+            if constexpr (is_std_list) {
+                std::list<int> rest;
+                rest.splice(rest.begin(), list, _at(record.position), list.end());
+                _sink(rest.size());
+            } else {
+                _sink(list.split_at(_at(record.position)).size());
+            }
+            break;
+        case TraceOp::PartitionInto: {
+            // the recorded count is what moved out, so the predicate keeps the rest
+            auto moved = _every(record.count, size);
+            auto keep = [&](const int& value) { return !moved(value); };
+
+            if constexpr (is_std_list) {
+                std::list<int> out;
+                _relink_partition(list, out, keep);
+                _sink(out.size());
+            } else {
+                ListType out;
+                _sink(list.partition_into(out, keep));
+            }
+            break;
+        }
+        case TraceOp::RadixSort:
+            if constexpr (is_std_list) list.sort();
+            else list.radix_sort();
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+struct ReplayStats {
+    std::string_view name;
+    double ops_per_second = 0;
+    std::array<long long, 5> percentiles{}; // p50 p90 p99 p99.9 max, nanoseconds
+};
+
+template <typename ListType, typename... Args>
+ReplayStats replay_trace(std::string_view name, const std::vector<TraceRecord>& records, Args&&... args) {
+    TraceReplay<ListType> replay(std::forward<Args>(args)...);
+    std::vector<long long> latencies;
+    latencies.reserve(records.size());
+
+    for (const TraceRecord& record : records) {
+        replay.prepare(record);
+
+        auto before = std::chrono::steady_clock::now();
+        replay.apply(record);
+        auto after = std::chrono::steady_clock::now();
+
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+    }
+
+    // prepare() is setup, only the applied calls count
+    double seconds = std::accumulate(latencies.begin(), latencies.end(), 0.0) / 1e9;
+
+    ReplayStats stats{name};
+    stats.ops_per_second = seconds > 0 ? records.size() / seconds : 0;
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+
+        constexpr std::array<double, 5> ranks = {0.5, 0.9, 0.99, 0.999, 1.0};
+
+        for (size_t i = 0; i < ranks.size(); ++i) {
+            stats.percentiles[i] = latencies[std::min(latencies.size() - 1, static_cast<size_t>(ranks[i] * latencies.size()))];
+        }
+    }
+    return stats;
+}
+
+// list replay <trace>: runs a recorded trace against the List configurations and std::list
+int replay_main(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<TraceRecord> records = TraceWriter::read(in);
+
+    if (records.empty()) {
+        std::cout << "no trace records in " << path << std::endl;
+        return 1;
+    }
+
+    std::array<size_t, static_cast<size_t>(TraceOp::Count)> mix{};
+    for (const TraceRecord& record : records) {
+        mix[static_cast<size_t>(record.op)]++;
+    }
+
+    std::cout << records.size() << " calls:";
+    for (size_t op = 0; op < mix.size(); ++op) {
+        if (mix[op]) std::cout << " " << trace_op_name(static_cast<TraceOp>(op)) << "=" << mix[op];
+    }
+    std::cout << std::endl << std::endl;
+
+    std::pmr::unsynchronized_pool_resource pool;
+
+    std::array<ReplayStats, 5> results = {
+        replay_trace<List<int, 24>>("List<int, 24>", records),
+        replay_trace<List<int, 4096>>("List<int, 4096>", records),
+        replay_trace<List<int, 24, NodeLayout::Split>>("List<int, 24, Split>", records),
+        replay_trace<List<int, 24>>("List<int, 24> + pmr pool", records, &pool, size_t{24}),
+        replay_trace<std::list<int>>("std::list<int>", records),
+    };
+
+    std::cout << std::left << std::setw(28) << "configuration" << std::right
+        << std::setw(14) << "ops/s" << std::setw(10) << "p50 ns" << std::setw(10) << "p90 ns"
+        << std::setw(10) << "p99 ns" << std::setw(11) << "p99.9 ns" << std::setw(12) << "max ns" << std::endl;
+
+    for (const ReplayStats& stats : results) {
+        std::cout << std::left << std::setw(28) << stats.name << std::right
+            << std::setw(14) << static_cast<long long>(stats.ops_per_second);
+
+        for (size_t i = 0; i < stats.percentiles.size(); ++i) {
+            std::cout << std::setw(i == 3 ? 11 : i == 4 ? 12 : 10) << stats.percentiles[i];
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
+
+// Upstream for ProfiledList's pools: every block NodeAllocator takes or hands back opens a PerfScope,
+// so pool traffic is profiled without List itself knowing. Stateless past upstream, one instance is shared.
+class PerfResource : public std::pmr::memory_resource {
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        PerfScope scope("pool::allocate");
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        PerfScope scope("pool::deallocate");
+        upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit PerfResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept : upstream(upstream) {}
+
+    static PerfResource* shared() noexcept {
+        static PerfResource resource;
+        return &resource;
+    }
+};
+
+// opt-in: a List whose public calls each open a PerfScope named after the call,
+// attach a PerfProfile to collect them. Each wrapper forwards whatever it is given,
+// so every List overload of that name stays reachable.
+// Pool blocks are reported through PerfResource::shared() unless the list is given a resource of its own.
+template <typename T, size_t Capacity = 24, NodeLayout Layout = NodeLayout::Inline>
+class ProfiledList : public List<T, Capacity, Layout> {
+    using Base = List<T, Capacity, Layout>;
+
+public:
+    using Base::Base;
+
+    explicit ProfiledList(size_t capacity = Capacity) : Base(PerfResource::shared(), capacity) {}
+
+#define PROFILED(name)                                              \
+    template <typename... Args>                                     \
+    decltype(auto) name(Args&&... args) {                           \
+        PerfScope scope(#name);                                     \
+        return Base::name(std::forward<Args>(args)...);             \
+    }
+
+#define PROFILED_CONST(name)                                        \
+    template <typename... Args>                                     \
+    _NODISCARD decltype(auto) name(Args&&... args) const {          \
+        PerfScope scope(#name);                                     \
+        return Base::name(std::forward<Args>(args)...);             \
+    }
+
+    PROFILED(reserve)
+    PROFILED(insert_front)
+    PROFILED(insert_back)
+    PROFILED(insert)
+    PROFILED(insert_range)
+    PROFILED(pop_front)
+    PROFILED(pop_back)
+    PROFILED(erase)
+    PROFILED(erase_range)
+    PROFILED(assign)
+    PROFILED(clear)
+    PROFILED_CONST(find)
+    PROFILED_CONST(find_if)
+    PROFILED(remove)
+    PROFILED(remove_if)
+    PROFILED(for_each)
+    PROFILED(sort)
+    PROFILED(radix_sort)
+    PROFILED(unique)
+
+#undef PROFILED
+#undef PROFILED_CONST
+
+    // a braced list does not deduce through Args
+    T_Convertible void assign(std::initializer_list<_T> ini_list) {
+        PerfScope scope("assign");
+        Base::assign(ini_list);
+    }
+};
+
+// list perf [csv]: counters per call type for a mixed workload, optionally exported as csv
+int perf_main(const char* csv_path) {
+    PerfProfile profile;
+    profile.attach();
+
+    {
+        ProfiledList<int> list;
+        uint32_t seed = 1;
+        auto next = [&] { return static_cast<int>((seed = seed * 1664525 + 1013904223) >> 8); };
+
+        for (int i = 0; i < 200000; ++i) {
+            list.insert_back(next());
+        }
+        for (int i = 0; i < 2000; ++i) {
+            list.insert_front(next());
+            list.insert(list.begin() + 64, next());
+        }
+        // pop_back walks to the node before tail
+        for (int i = 0; i < 100; ++i) {
+            list.pop_back();
+        }
+
+        long long sum = 0;
+
+        for (int i = 0; i < 50; ++i) {
+            int target = next();
+            sum += list.find_if([&](int value) { return value == target; }) != list.end();
+        }
+        list.for_each([&](int value) { sum += value; });
+
+        volatile long long sink = sum;
+        (void)sink;
+
+        list.remove_if([](int value) { return value % 3 == 0; });
+        list.radix_sort();
+        list.sort();
+        list.unique();
+        list.erase_range(list.begin(), list.begin() + 1000);
+        list.clear();
+    }
+
+    profile.detach();
+
+    if (!profile.get_counters().get_fallback_reason().empty()) {
+        std::cout << "timing only, " << profile.get_counters().get_fallback_reason() << std::endl << std::endl;
+    }
+    profile.print(std::cout);
+
+    if (csv_path) {
+        std::ofstream out(csv_path);
+        profile.export_csv(out);
+
+        if (!out) {
+            std::cout << "could not write " << csv_path << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+
+
+template <size_t MultiplyFactor>
+struct NumberGenerator {
+    int x = 1;
+
+    constexpr int operator ()() {
+        return x *= MultiplyFactor;
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::string_view(argv[1]) == "replay") {
+        return replay_main(argv[2]);
+    }
+
+    if (argc >= 2 && std::string_view(argv[1]) == "perf") {
+        return perf_main(argc >= 3 ? argv[2] : nullptr);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    List<int, 10> list;
+    int i = 0;
+
+
+    auto print = [](auto&&v){
+        std::cout << v << std::endl;
+    };
+
+  //  list.for_each([](auto&&val){ std::cout << val << std::endl;});
+
+  //  list.insert_back(3);
+ //   list.insert_back(3);
+  //  list.assign(5, 5);
+
+    list.insert_range(list.begin(), 11, NumberGenerator<2>{});
+    list.erase(list.begin() + 5);
+
+    list.insert_back(65);
+    list.insert_back(66);
+    list.erase_range(list.begin(), list.begin() + 3);
+    list.assign(5, NumberGenerator<2>{});
+    list.insert_range(list.begin() + 2, 5,6,7);
+    list.insert_front(5);
+    list.insert_back(10);
+    list.erase(list.begin() + 1);
+    list.remove_if([](auto&&v){return false;});
+    auto it = list.find_if([](auto&&v){return false;});
+    list.unique_all();
+
+    auto n = list.filter([](auto&&v){
+        return v % 2 == 0;
+    });
+
+    n.for_each(print);
+
+
+
+    constexpr auto table = [] {
+        List<int, 4> compile_time;
+        compile_time.insert_range(compile_time.begin(), 6, NumberGenerator<3>{});
+        compile_time.insert_back(1);
+        compile_time.sort();
+        return compile_time.to_array<7>();
+    }();
+
+    std::cout << "-" << std::endl << std::endl;
+    for (int v : table) print(v);
+
+    std::cout << "-" << std::endl << std::endl;
+    list.sort();
+    list.for_each(print);
+
+    auto f = n;
+    std::cout << "-" << std::endl << std::endl;
+   // f.for_each(print);
+
+    if (n == f) {
+        std::cout << "n==list\n";
+    }
+
+    if (list > n) {
+        std::cout << "LIST > N\n";
+    }
+
+    if (n > list) {
+        std::cout << "N > LIST\n";
+    }
+
+    if (n < list) {
+        std::cout << "N < LIST\n";
+    }
+
+    if (list < n) {
+        std::cout << "LIST < N\n";
+    }
+
+    {
+        // eviction drops the least recently used entry, a touch refreshes one
+        std::vector<int> evicted;
+        LruCache<int, std::string, 2> cache([&](const int& key, std::string&) { evicted.push_back(key); });
+
+        cache.put(1, "one");
+        cache.put(2, "two");
+        cache.touch(1);
+        cache.put(3, "three");
+
+        assert(evicted == std::vector<int>{2});
+        assert(cache.contains(1) && !cache.contains(2) && cache.contains(3));
+        assert(*cache.lru_key() == 1);
+
+        // keys sharing a probe chain: erasing shifts the rest back, every remaining key stays reachable
+        LruCache<int, int, 64> chained;
+
+        for (int key = 0; key < 64; ++key) chained.put(key * 128, key);
+        for (int key = 0; key < 64; key += 2) chained.erase(key * 128);
+
+        for (int key = 0; key < 64; ++key) {
+            const int* value = chained.peek(key * 128);
+            assert(key % 2 == 0 ? value == nullptr : value && *value == key);
+        }
+        assert(chained.size() == 32);
+    }
+
+    {
+        // the index follows every mutation: inserts, erase through an iterator, removal by value, growth
+        IndexedList<int> indexed{3, 1, 3, 2};
+        assert(indexed.count(3) == 2 && indexed.contains(2) && !indexed.contains(4));
+
+        indexed.erase(indexed.find(2));
+        assert(!indexed.contains(2) && indexed.size() == 3);
+
+        assert(indexed.remove(3) == 2);
+        assert(!indexed.contains(3) && indexed.size() == 1 && *indexed.begin() == 1);
+
+        for (int i = 0; i < 100; ++i) indexed.insert_back(i % 10);
+        assert(indexed.count(1) == 11 && indexed.count(7) == 10);
+
+        indexed.remove_if([](int v) { return v > 1; });
+        indexed.sort();
+
+        // like List::sort, equal elements collapse to the first one
+        const int expected[] = {0, 1};
+        assert(std::equal(indexed.begin(), indexed.end(), std::begin(expected), std::end(expected)));
+        assert(indexed.count(1) == 1);
+
+        // find returns the first equal element in list order, also after a middle insert
+        IndexedList<int> ordered{5, 7, 5};
+        ordered.insert(ordered.begin() + 1, 5);
+        ordered.insert_front(7);
+        auto first_five = ordered.find(5);
+        assert(std::distance(ordered.begin(), first_five) == 1);
+        ordered.erase(first_five);
+        assert(std::distance(ordered.begin(), ordered.find(5)) == 1 && ordered.count(5) == 2);
+
+        // a duplicate inserted away from any equal element joins the back of its chain
+        IndexedList<int> unordered{7, 9, 5};
+        unordered.insert(unordered.begin() + 1, 5);
+        assert(std::distance(unordered.begin(), unordered.find(5)) == 3 && unordered.count(5) == 2);
+        assert(unordered.remove(5) == 2 && unordered.size() == 2);
+    }
+
+    {
+        // stays ordered through inserts and erases, range scans stop at the bound
+        SortedList<int> sorted;
+        for (int i = 0; i < 200; ++i) sorted.insert((i * 37) % 200 % 50);
+
+        assert(sorted.size() == 200 && std::is_sorted(sorted.begin(), sorted.end()));
+        assert(sorted.count(5) == 4 && sorted.count(49) == 4);
+
+        assert(sorted.erase(5) == 4);
+        sorted.erase(sorted.find(49));
+        sorted.pop_front();
+        sorted.pop_front();
+
+        assert(sorted.size() == 193 && std::is_sorted(sorted.begin(), sorted.end()));
+        assert(!sorted.contains(5) && sorted.count(49) == 3 && sorted.count(0) == 2);
+
+        auto middle = sorted.range(10, 13);
+        assert(std::ranges::distance(middle) == 12 && *middle.begin() == 10);
+
+        // the List signatures compile, position and sort order come from Compare
+        SortedList<int, 8, std::greater<int>> descending{2, 9};
+        descending.insert(descending.end(), 5);
+        const int more[] = {7, 1};
+        descending.insert_range(descending.begin(), std::begin(more), std::end(more));
+        descending.insert_range(descending.begin(), std::vector<int>{3, 3});
+        descending.sort(std::less<int>{});
+
+        const int expected[] = {9, 7, 5, 3, 3, 2, 1};
+        assert(std::equal(descending.begin(), descending.end(), std::begin(expected), std::end(expected)));
+    }
+
+    {
+        // compact() keeps every list's contents and leaves each one contiguous, with no free slots
+        ListArena<int> arena;
+        arena.build(std::vector<std::pair<uint32_t, int>>{ {0, 1}, {1, 2}, {0, 3}, {2, 4}, {1, 5}, {0, 6} });
+        arena.insert_front(2, 7);
+        arena.clear(1);
+        arena.remove_if(0, [](int v) { return v == 3; });
+
+        assert(arena.node_count() == 4 && arena.fragmentation() > 0);
+        arena.compact();
+        assert(arena.node_count() == 4 && arena.fragmentation() == 0);
+
+        const int first[] = {1, 6};
+        const int third[] = {7, 4};
+        assert(std::equal(arena.begin(0), arena.end(0), std::begin(first), std::end(first)));
+        assert(arena.empty(1));
+        assert(std::equal(arena.begin(2), arena.end(2), std::begin(third), std::end(third)));
+        assert(arena.handle(0).tail == arena.handle(0).head + 1 && arena.handle(2).tail == arena.handle(2).head + 1);
+    }
+
+    {
+        // writes after a snapshot, at either end or in the middle, leave the snapshot as it was
+        PersistentList<int> persistent;
+        for (int i = 1; i <= 4; ++i) persistent.insert_back(i);
+
+        auto snapshot = persistent.snapshot();
+        PersistentList<int> copy = persistent;
+
+        persistent.insert_back(5);
+        persistent.set(persistent.find(2), 20);
+        persistent.erase(persistent.find(3));
+        persistent.pop_front();
+        copy.insert_front(0);
+
+        const int before[] = {1, 2, 3, 4};
+        const int after[] = {20, 4, 5};
+        const int copied[] = {0, 1, 2, 3, 4};
+        assert(snapshot.size() == 4 && std::equal(snapshot.begin(), snapshot.end(), std::begin(before), std::end(before)));
+        assert(std::equal(persistent.begin(), persistent.end(), std::begin(after), std::end(after)));
+        assert(std::equal(copy.begin(), copy.end(), std::begin(copied), std::end(copied)));
+    }
+
+    {
+        // a node unlinked during a read section is not reused until the section closes
+        ConcurrentList<int> concurrent;
+        for (int i = 0; i < 8; ++i) concurrent.insert_back(i);
+
+        auto reader = concurrent.reader();
+        {
+            auto section = reader.read();
+            const int* first = &*section.begin();
+
+            concurrent.erase(concurrent.begin());
+            for (int i = 0; i < 64; ++i) {
+                concurrent.reclaim();
+                concurrent.insert_back(100 + i);
+                concurrent.pop_front();
+            }
+            assert(*first == 0);
+        }
+
+        // a nested helper closing its own section keeps the outer one protected
+        {
+            auto section = reader.read();
+            const int* first = &*section.begin();
+            const int value = *first;
+
+            assert(reader.contains(value));
+            concurrent.erase(concurrent.begin());
+            for (int i = 0; i < 64; ++i) {
+                concurrent.reclaim();
+                concurrent.insert_back(200 + i);
+                concurrent.pop_front();
+            }
+            assert(*first == value);
+        }
+
+        // moving the Reader leaves its open section publishing the same slot
+        auto moved = std::move(reader);
+        {
+            auto section = moved.read();
+            const int* first = &*section.begin();
+            const int value = *first;
+
+            reader = std::move(moved);
+            concurrent.erase(concurrent.begin());
+            for (int i = 0; i < 64; ++i) {
+                concurrent.reclaim();
+                concurrent.insert_back(300 + i);
+                concurrent.pop_front();
+            }
+            assert(*first == value);
+        }
+        assert(reader.contains(*concurrent.begin()));
+
+        // readers scanning while the writer erases only ever see consecutive values
+        concurrent.clear();
+        for (int i = 0; i < 16; ++i) concurrent.insert_back(i);
+
+        std::atomic<bool> done = false;
+        std::atomic<bool> consistent = true;
+
+        std::thread scanner([&] {
+            auto scan = concurrent.reader();
+
+            while (!done.load()) {
+                int previous = -1;
+
+                scan.for_each([&](const int& value) {
+                    if (previous != -1 && value != previous + 1) consistent = false;
+                    previous = value;
+                });
+            }
+        });
+
+        for (int i = 16; i < 20000; ++i) {
+            concurrent.insert_back(i);
+            concurrent.erase(concurrent.begin());
+            if (i % 64 == 0) concurrent.reclaim();
+        }
+        done = true;
+        scanner.join();
+
+        assert(consistent && concurrent.size() == 16);
+    }
+
+    {
+        // each call lands in the trace with the position it worked at and the size before it
+        std::stringstream trace_buffer;
+        TraceWriter trace(trace_buffer);
+        RecordingList<int> recorded(trace);
+
+        for (int i = 0; i < 5; ++i) recorded.insert_back(i);
+        recorded.insert(recorded.begin() + 2, 10);
+        recorded.erase(recorded.begin() + 4);
+        (void)recorded.find(10);
+        recorded.remove_if([](int v) { return v < 2; });
+
+        std::vector<TraceRecord> records = TraceWriter::read(trace_buffer);
+
+        assert(records.size() == 9);
+        assert(records[4].op == TraceOp::InsertBack && records[4].position == 4);
+        assert(records[5].op == TraceOp::Insert && records[5].position == 2 && records[5].size == 5);
+        assert(records[6].op == TraceOp::Erase && records[6].position == 4 && records[6].size == 6);
+        assert(records[7].op == TraceOp::Find && records[7].position == 2);
+        assert(records[8].op == TraceOp::RemoveIf && records[8].size == 5 && records[8].count == 2);
+
+        // positions and sizes past 32 bits are written whole
+        std::stringstream wide_buffer;
+        TraceWriter wide(wide_buffer);
+        wide.write(TraceRecord{TraceOp::Erase, uint64_t{1} << 40, (uint64_t{1} << 40) + 1});
+
+        records = TraceWriter::read(wide_buffer);
+        assert(records.size() == 1 && records[0].position == uint64_t{1} << 40 && records[0].size == (uint64_t{1} << 40) + 1);
+    }
+
+    {
+        // copies own their nodes, + builds a new list, merge drains the other list
+        List<int> original{1, 2, 3};
+        List<int> copy(original);
+        copy.insert_back(4);
+        assert(original.size() == 3 && copy.size() == 4);
+        assert(original != copy && !(original == copy));
+
+        List<int> joined = original + copy;
+        assert(joined.size() == 7 && original.size() == 3);
+
+        original += original;
+        assert(original.size() == 6);
+
+        copy.merge(copy);
+        assert(copy.size() == 4);
+        original.merge(copy);
+        assert(original.size() == 10 && copy.size() == 0);
+    }
+
+    {
+        // equal contents hash equal however they were built, order counts
+        using HashedList = List<int, 24, NodeLayout::Inline, Hashing::Content>;
+
+        HashedList built{1, 2, 3};
+        HashedList edited;
+        edited.insert_back(1);
+        edited.insert_back(3);
+        edited.insert(edited.begin() + 1, 2);
+        HashedList reversed{3, 2, 1};
+
+        assert(built == edited && built.hash() == edited.hash());
+        assert(built != reversed && built.hash() != reversed.hash());
+
+        HashedList copy(built);
+        assert(copy.hash() == built.hash());
+        copy.erase(copy.begin());
+        copy.insert_front(1);
+        assert(copy.hash() == built.hash());
+
+        // same adjacent pairs, different order
+        HashedList rising, falling;
+        for (int v : {1, 2, 1, 3, 1}) rising.insert_back(v);
+        for (int v : {1, 3, 1, 2, 1}) falling.insert_back(v);
+        assert(rising.hash() != falling.hash());
+
+        std::unordered_map<HashedList, int> cached;
+        cached[built] = 6;
+        assert(cached.contains(edited) && !cached.contains(reversed));
+    }
+
+    {
+        // both split directions keep every element on the right side, in order
+        const int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+        for (int at : {2, 8}) {
+            List<int> whole;
+            for (int v : values) whole.insert_back(v);
+
+            List<int> rest = whole.split_at(whole.begin() + at);
+            assert(whole.size() == at && rest.size() == 10 - at);
+            assert(std::equal(whole.begin(), whole.end(), values, values + at));
+            assert(std::equal(rest.begin(), rest.end(), values + at, std::end(values)));
+        }
+
+        List<int> mixed;
+        for (int v : values) mixed.insert_back(v);
+        List<int> odd;
+        assert(mixed.partition_into(odd, [](int v) { return v % 2 == 0; }) == 5);
+
+        const int even_values[] = {0, 2, 4, 6, 8};
+        const int odd_values[] = {1, 3, 5, 7, 9};
+        assert(std::equal(mixed.begin(), mixed.end(), std::begin(even_values), std::end(even_values)));
+        assert(std::equal(odd.begin(), odd.end(), std::begin(odd_values), std::end(odd_values)));
+    }
+
+    {
+        // an erased or popped element is destroyed right away, not when its slot is reused
+        auto owned = std::make_shared<int>(1);
+        List<std::shared_ptr<int>> holders;
+        holders.insert_back(owned);
+        holders.insert_back(owned);
+        holders.insert_back(owned);
+        assert(owned.use_count() == 4);
+
+        holders.erase(holders.begin());
+        holders.pop_back();
+        assert(owned.use_count() == 2);
+
+        holders.clear();
+        assert(owned.use_count() == 1);
+    }
+
+    {
+        // erased and evicted entries release their value right away
+        auto owned = std::make_shared<int>(1);
+        LruCache<int, std::shared_ptr<int>, 2> cache;
+        cache.put(1, owned);
+        cache.put(2, owned);
+        assert(owned.use_count() == 3);
+
+        cache.erase(1);
+        assert(owned.use_count() == 2);
+
+        cache.put(3, nullptr);
+        cache.put(4, nullptr);
+        assert(owned.use_count() == 1 && !cache.contains(2));
+    }
+
+    {
+        // a slot freed by pop_front or clear releases its element at once
+        auto owned = std::make_shared<int>(1);
+        ListArena<std::shared_ptr<int>> owners(2);
+        owners.insert_back(0, owned);
+        owners.insert_back(0, owned);
+        owners.insert_back(1, owned);
+        assert(owned.use_count() == 4);
+
+        owners.pop_front(0);
+        assert(owned.use_count() == 3);
+        owners.clear(1);
+        assert(owned.use_count() == 2);
+    }
+
+    {
+        // ProfiledList reports its calls and, through PerfResource, its pool blocks; a plain List reports nothing
+        PerfProfile profile;
+        profile.attach();
+
+        List<int> plain;
+        for (int i = 0; i < 100; ++i) plain.insert_back(i);
+        assert(profile.get_totals().empty());
+
+        {
+            ProfiledList<int> profiled;
+            for (int i = 0; i < 100; ++i) profiled.insert_back(i);
+        }
+        profile.detach();
+
+        const auto& totals = profile.get_totals();
+        assert(totals.at("insert_back").calls == 100);
+        assert(totals.at("pool::allocate").calls > 0);
+        assert(totals.at("pool::allocate").calls == totals.at("pool::deallocate").calls);
+    }
+
+    {
+        // 8 bit keys take the same path as wider ones, one pass, signed order kept
+        List<signed char> small;
+        for (int v : {5, -3, 127, -128, 0, -3}) small.insert_back(static_cast<signed char>(v));
+        small.radix_sort();
+
+        const signed char small_sorted[] = {-128, -3, -3, 0, 5, 127};
+        assert(std::equal(small.begin(), small.end(), std::begin(small_sorted), std::end(small_sorted)));
+
+        List<int> wide;
+        for (int v : {70000, -1, 3, -70000, 3}) wide.insert_back(v);
+        wide.radix_sort();
+
+        const int wide_sorted[] = {-70000, -1, 3, 3, 70000};
+        assert(std::equal(wide.begin(), wide.end(), std::begin(wide_sorted), std::end(wide_sorted)));
     }
 
     auto end = std::chrono::high_resolution_clock::now();